@@ -0,0 +1,619 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ======================
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+#include "Core/Context.h"
+#include "Core/Stopwatch.h"
+#include "Core/FileSystem.h"
+#include "Core/EventSystem.h"
+#include "IO/FileStream.h"
+#include "Resource/ResourceCache.h"
+#include "Threading/Threading.h"
+#include "World/World.h"
+#include "World/Entity.h"
+#include "World/Components/Transform.h"
+//=================================
+
+//= NAMESPACES ==========
+using namespace std;
+using namespace Spartan;
+//=======================
+
+// Measures the engine's hot paths outside of a running engine, so changes to them can be compared run to run
+namespace _Benchmark
+{
+    const string directory = "Benchmark_temp/";
+
+    // Prints how long a number of operations took, in total and per operation
+    void report(const char* name, const uint64_t count, const float ms)
+    {
+        printf("%-44s %10llu ops %10.2f ms %10.1f ns/op\n", name, static_cast<unsigned long long>(count), ms, static_cast<double>(ms) * 1000000.0 / count);
+    }
+
+    // Heap allocations made by any thread while counting is enabled, see the operator new below
+    atomic<bool> allocations_counting   = false;
+    atomic<uint64_t> allocation_count   = 0;
+
+    // Runs the function and returns how many heap allocations it made
+    template <typename Function>
+    uint64_t count_allocations(Function&& function)
+    {
+        allocation_count        = 0;
+        allocations_counting    = true;
+        function();
+        allocations_counting    = false;
+        return allocation_count.load();
+    }
+
+    void report_allocations(const char* name, const uint64_t count, const uint64_t allocations)
+    {
+        printf("%-44s %10llu ops %10.2f allocations/op\n", name, static_cast<unsigned long long>(count), static_cast<double>(allocations) / count);
+    }
+
+    // A resource which only exists to fill the cache, it has no data and nothing to save
+    class Resource_Benchmark : public IResource
+    {
+    public:
+        Resource_Benchmark(Context* context) : IResource(context, Resource_Material) {}
+    };
+
+    // The thread pool as it was before the work stealing deques, a single locked queue which every worker pops from
+    class ThreadPool_GlobalQueue
+    {
+    public:
+        ThreadPool_GlobalQueue(const uint32_t worker_count)
+        {
+            for (uint32_t i = 0; i < worker_count; i++)
+            {
+                m_threads.emplace_back([this]() { ThreadLoop(); });
+            }
+        }
+
+        ~ThreadPool_GlobalQueue()
+        {
+            {
+                lock_guard<mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_condition_var.notify_all();
+
+            for (thread& thread : m_threads)
+            {
+                thread.join();
+            }
+        }
+
+        void AddTask(function<void()>&& task)
+        {
+            m_pending++;
+            {
+                lock_guard<mutex> lock(m_mutex);
+                m_tasks.emplace_back(make_shared<function<void()>>(move(task)));
+            }
+            m_condition_var.notify_one();
+        }
+
+        void Flush()
+        {
+            while (m_pending.load() != 0)
+            {
+                this_thread::yield();
+            }
+        }
+
+    private:
+        void ThreadLoop()
+        {
+            while (true)
+            {
+                unique_lock<mutex> lock(m_mutex);
+                m_condition_var.wait(lock, [this] { return !m_tasks.empty() || m_stopping; });
+
+                if (m_stopping && m_tasks.empty())
+                    return;
+
+                shared_ptr<function<void()>> task = m_tasks.front();
+                m_tasks.pop_front();
+                lock.unlock();
+
+                (*task)();
+                m_pending--;
+            }
+        }
+
+        vector<thread> m_threads;
+        deque<shared_ptr<function<void()>>> m_tasks;
+        mutex m_mutex;
+        condition_variable m_condition_var;
+        atomic<uint32_t> m_pending  = 0;
+        bool m_stopping             = false;
+    };
+
+    void tasks(Context* context)
+    {
+        const uint32_t task_count   = 200000;
+        const uint32_t batch_size   = 2048; // below the capacity of a deque (4096), a full deque makes the adding thread run the task inline
+        const uint32_t batch_count  = task_count / batch_size;
+        const uint32_t thread_count = max(thread::hardware_concurrency(), 1u);
+        atomic<uint32_t> counter    = 0;
+
+        // Runs with 1, 2, 4 ... workers (plus the main thread), up to what the hardware supports
+        for (uint32_t worker_count = 1; worker_count < thread_count; worker_count = min(worker_count * 2, thread_count - 1))
+        {
+            const string workers = " (" + to_string(worker_count) + (worker_count == 1 ? " worker)" : " workers)");
+
+            {
+                Threading threading(context, worker_count + 1);
+
+                // The main thread has its own deque (index 0), the workers steal from it
+                {
+                    const string name = "AddTask, main thread" + workers;
+                    Stopwatch timer;
+                    const uint64_t allocations = count_allocations([&]()
+                    {
+                        for (uint32_t batch = 0; batch < batch_count; batch++)
+                        {
+                            for (uint32_t i = 0; i < batch_size; i++)
+                            {
+                                threading.AddTask([&counter]() { counter++; });
+                            }
+                            threading.Flush();
+                        }
+                    });
+                    report(name.c_str(), batch_count * batch_size, timer.GetElapsedTimeMs());
+                    report_allocations(name.c_str(), batch_count * batch_size, allocations);
+                }
+
+                // Each batch is added by a task, so it goes to that worker's deque and idle workers steal from it
+                {
+                    const string name = "AddTask, worker" + workers;
+                    Stopwatch timer;
+                    for (uint32_t batch = 0; batch < batch_count; batch++)
+                    {
+                        threading.AddTask([&threading, &counter, batch_size]()
+                        {
+                            for (uint32_t i = 0; i < batch_size; i++)
+                            {
+                                threading.AddTask([&counter]() { counter++; });
+                            }
+                        });
+                    }
+                    threading.Flush();
+                    report(name.c_str(), batch_count * batch_size, timer.GetElapsedTimeMs());
+                }
+
+                // Continuations, every task is queued by the one before it
+                {
+                    const string name           = "AddTaskAfter, chain" + workers;
+                    const uint32_t chain_length = 20000;
+                    Stopwatch timer;
+                    TaskHandle previous = threading.AddTask([&counter]() { counter++; });
+                    for (uint32_t i = 1; i < chain_length; i++)
+                    {
+                        previous = threading.AddTaskAfter(previous, [&counter]() { counter++; });
+                    }
+                    threading.Wait(previous);
+                    report(name.c_str(), chain_length, timer.GetElapsedTimeMs());
+                }
+            }
+
+            // The same batches from the main thread, through the old global queue
+            {
+                ThreadPool_GlobalQueue pool(worker_count);
+                const string name = "AddTask, global queue" + workers;
+                Stopwatch timer;
+                const uint64_t allocations = count_allocations([&]()
+                {
+                    for (uint32_t batch = 0; batch < batch_count; batch++)
+                    {
+                        for (uint32_t i = 0; i < batch_size; i++)
+                        {
+                            pool.AddTask([&counter]() { counter++; });
+                        }
+                        pool.Flush();
+                    }
+                });
+                report(name.c_str(), batch_count * batch_size, timer.GetElapsedTimeMs());
+                report_allocations(name.c_str(), batch_count * batch_size, allocations);
+            }
+
+            if (worker_count == thread_count - 1)
+                break;
+        }
+    }
+
+    void loops(Threading* threading)
+    {
+        const uint32_t count = 1 << 22;
+        vector<float> values(count, 1.0f);
+        atomic<uint32_t> sink = 0;
+
+        auto sum = [&values, &sink](const uint32_t start, const uint32_t end)
+        {
+            float total = 0.0f;
+            for (uint32_t i = start; i < end; i++)
+            {
+                total += values[i] * values[i];
+            }
+            sink += static_cast<uint32_t>(total);
+        };
+
+        {
+            Stopwatch timer;
+            sum(0, count);
+            report("Loop (serial)", count, timer.GetElapsedTimeMs());
+        }
+
+        // ExecuteChunks is what AddTaskLoop and the rest of the parallel algorithms are built on, so the grain is what's measured
+        const uint32_t grains[] = { 0, 64, 1024, 65536 };
+        for (const uint32_t grain : grains)
+        {
+            const string name = "AddTaskLoop (grain " + (grain == 0 ? string("auto") : to_string(grain)) + ")";
+            Stopwatch timer;
+            threading->AddTaskLoop(sum, count, grain);
+            report(name.c_str(), count, timer.GetElapsedTimeMs());
+        }
+    }
+
+    void events()
+    {
+        const uint32_t fire_count   = 100000;
+        uint32_t counter            = 0;
+
+        // Dispatch walks a flat table, so the cost per subscriber should stay the same as they grow in number
+        const uint32_t subscriber_counts[] = { 1, 10, 100, 1000 };
+        for (const uint32_t subscriber_count : subscriber_counts)
+        {
+            vector<EventHandle> handles;
+            for (uint32_t i = 0; i < subscriber_count; i++)
+            {
+                handles.emplace_back(SUBSCRIBE_TO_EVENT(Event_Frame_Resolution_Changed, [&counter](const Variant&) { counter++; }));
+            }
+
+            {
+                const string name = "FIRE_EVENT (" + to_string(subscriber_count) + (subscriber_count == 1 ? " subscriber)" : " subscribers)");
+                Stopwatch timer;
+                for (uint32_t i = 0; i < fire_count; i++)
+                {
+                    FIRE_EVENT(Event_Frame_Resolution_Changed);
+                }
+                report(name.c_str(), static_cast<uint64_t>(fire_count) * subscriber_count, timer.GetElapsedTimeMs());
+            }
+
+            for (const EventHandle& handle : handles)
+            {
+                UNSUBSCRIBE_FROM_EVENT(handle);
+            }
+        }
+    }
+
+    void cache(Context* context, Threading* threading)
+    {
+        ResourceCache* resource_cache   = context->GetSubsystem<ResourceCache>();
+        const uint32_t lookup_count     = 1000000;
+
+        // The cache grows between the runs, lookups are hashed so their cost should stay flat
+        const uint32_t resource_counts[] = { 1000, 10000, 50000 };
+        vector<string> names;
+        uint32_t resource_index = 0;
+        for (const uint32_t resource_count : resource_counts)
+        {
+            for (; resource_index < resource_count; resource_index++)
+            {
+                auto resource = make_shared<Resource_Benchmark>(context);
+                resource->SetResourceFilePath(directory + "resource_" + to_string(resource_index) + EXTENSION_MATERIAL);
+                if (resource_cache->Cache(resource))
+                {
+                    names.emplace_back(resource->GetResourceName());
+                }
+            }
+
+            if (names.empty())
+                return;
+
+            const string resources = " (" + to_string(resource_count) + " resources)";
+
+            {
+                const string name = "ResourceCache::GetByName" + resources;
+                Stopwatch timer;
+                for (uint32_t i = 0; i < lookup_count; i++)
+                {
+                    resource_cache->GetByName(names[i % names.size()], Resource_Material);
+                }
+                report(name.c_str(), lookup_count, timer.GetElapsedTimeMs());
+            }
+
+            // Lookups take a shared lock, so they should scale with the threads
+            {
+                const string name = "ResourceCache::GetByName, parallel" + resources;
+                Stopwatch timer;
+                threading->AddTaskLoop([resource_cache, &names](const uint32_t start, const uint32_t end)
+                {
+                    for (uint32_t i = start; i < end; i++)
+                    {
+                        resource_cache->GetByName(names[i % names.size()], Resource_Material);
+                    }
+                }, lookup_count);
+                report(name.c_str(), lookup_count, timer.GetElapsedTimeMs());
+            }
+        }
+
+        resource_cache->Clear();
+    }
+
+    void components(World* world)
+    {
+        const uint32_t entity_count = 100000;
+        for (uint32_t i = 0; i < entity_count; i++)
+        {
+            world->EntityCreate();
+        }
+
+        // Keeps the reads from being optimized away
+        volatile float sink = 0.0f;
+
+        // The packed array of the type, one pointer after the other
+        {
+            Stopwatch timer;
+            float total = 0.0f;
+            for (Transform* transform : world->ComponentGetAll<Transform>())
+            {
+                total += transform->GetPositionLocal().x;
+            }
+            sink = total;
+            report("ComponentGetAll<Transform>", entity_count, timer.GetElapsedTimeMs());
+        }
+
+        // What systems did before, every entity and then a search through its components
+        {
+            Stopwatch timer;
+            float total = 0.0f;
+            for (const auto& entity : world->EntityGetAll())
+            {
+                if (Transform* transform = entity->GetComponent<Transform>())
+                {
+                    total += transform->GetPositionLocal().x;
+                }
+            }
+            sink = total;
+            report("EntityGetAll + GetComponent<Transform>", entity_count, timer.GetElapsedTimeMs());
+        }
+
+        world->Unload();
+    }
+
+    void transforms(World* world)
+    {
+        const uint32_t update_count = 100;
+
+        // Moves the root and brings the whole hierarchy up to date, as a tick would
+        const auto measure = [world, update_count](const char* name, Transform* root, const uint32_t transform_count)
+        {
+            Stopwatch timer;
+            for (uint32_t i = 0; i < update_count; i++)
+            {
+                root->SetPositionLocal(Math::Vector3(static_cast<float>(i), 0.0f, 0.0f));
+                world->TransformsUpdate();
+            }
+            report(name, static_cast<uint64_t>(update_count) * transform_count, timer.GetElapsedTimeMs());
+        };
+
+        // Every level has a single transform, so the levels resolve one after the other
+        {
+            const uint32_t depth = 10000;
+            Transform* root     = world->EntityCreate()->GetTransform();
+            Transform* parent   = root;
+            for (uint32_t i = 1; i < depth; i++)
+            {
+                Transform* transform = world->EntityCreate()->GetTransform();
+                transform->SetParent(parent);
+                parent = transform;
+            }
+            world->TransformsUpdate();
+
+            measure("TransformsUpdate (deep, 10k levels)", root, depth);
+            world->Unload();
+        }
+
+        // A single level with all the children, resolved in parallel
+        {
+            const uint32_t child_count = 100000;
+            Transform* root = world->EntityCreate()->GetTransform();
+            for (uint32_t i = 0; i < child_count; i++)
+            {
+                world->EntityCreate()->GetTransform()->SetParent(root);
+            }
+            world->TransformsUpdate();
+
+            measure("TransformsUpdate (wide, 100k children)", root, child_count + 1);
+
+            // Nothing moved, so there should be nothing to walk
+            {
+                Stopwatch timer;
+                for (uint32_t i = 0; i < update_count; i++)
+                {
+                    world->TransformsUpdate();
+                }
+                report("TransformsUpdate (wide, nothing dirty)", update_count, timer.GetElapsedTimeMs());
+            }
+
+            world->Unload();
+        }
+    }
+
+    void world_io(World* world)
+    {
+        // A few thousand entities, as small hierarchies
+        const uint32_t root_count   = 256;
+        const uint32_t child_count  = 15;
+        const uint32_t entity_count = root_count * (child_count + 1);
+        for (uint32_t i = 0; i < root_count; i++)
+        {
+            Transform* root = world->EntityCreate()->GetTransform();
+            root->SetPositionLocal(Math::Vector3(static_cast<float>(i), 0.0f, 0.0f));
+
+            for (uint32_t j = 0; j < child_count; j++)
+            {
+                Transform* child = world->EntityCreate()->GetTransform();
+                child->SetParent(root);
+                child->SetPositionLocal(Math::Vector3(0.0f, static_cast<float>(j), 0.0f));
+            }
+        }
+
+        const string path = directory + "world" + EXTENSION_WORLD;
+
+        {
+            Stopwatch timer;
+            world->SaveToFile(path);
+            report("World::SaveToFile (entities)", entity_count, timer.GetElapsedTimeMs());
+        }
+
+        {
+            Stopwatch timer;
+            world->LoadFromFile(path);
+            report("World::LoadFromFile (entities)", entity_count, timer.GetElapsedTimeMs());
+        }
+
+        if (world->EntityGetCount() != entity_count)
+        {
+            printf("World::LoadFromFile loaded %u of %u entities\n", world->EntityGetCount(), entity_count);
+        }
+
+        world->Unload();
+    }
+
+    void file_io(Threading* threading)
+    {
+        const uint32_t block_count  = 64;
+        const uint32_t block_size   = 1024 * 1024;
+        const uint64_t byte_count   = static_cast<uint64_t>(block_count) * block_size;
+
+        // Half of the bytes repeat, so compression has something to do
+        vector<std::byte> block(block_size);
+        for (uint32_t i = 0; i < block_size; i++)
+        {
+            block[i] = static_cast<std::byte>(i < block_size / 2 ? (i * 2654435761u) >> 24 : i % 7);
+        }
+
+        const auto write = [&block, block_count](const string& path, const uint32_t flags)
+        {
+            FileStream file(path, FileStream_Write | flags);
+            for (uint32_t i = 0; i < block_count; i++)
+            {
+                file.Write(block);
+            }
+        };
+
+        const auto read = [&block, block_count](const string& path, const uint32_t flags)
+        {
+            FileStream file(path, FileStream_Read | flags);
+            vector<std::byte> data;
+            for (uint32_t i = 0; i < block_count; i++)
+            {
+                file.Read(&data);
+            }
+        };
+
+        const string path               = directory + "file.bin";
+        const string path_compressed    = directory + "file_compressed.bin";
+
+        const auto measure = [byte_count](const char* name, const auto& function)
+        {
+            Stopwatch timer;
+            function();
+            report(name, byte_count >> 20, timer.GetElapsedTimeMs());
+        };
+
+        measure("FileStream write (MB)",          [&]() { write(path, 0); });
+        measure("FileStream read (MB)",           [&]() { read(path, 0); });
+        measure("FileStream read, mapped (MB)",   [&]() { read(path, FileStream_Mmap); });
+
+        // Zero-copy, the views point into the mapped file
+        measure("FileStream read, mapped views (MB)", [&]()
+        {
+            FileStream file(path, FileStream_Read | FileStream_Mmap);
+            for (uint32_t i = 0; i < block_count; i++)
+            {
+                uint32_t count = 0;
+                file.ReadView<std::byte>(&count);
+            }
+        });
+
+        // Compressed blocks are decoded in parallel
+        FileStream::SetThreading(threading);
+        measure("FileStream write, compressed (MB)",  [&]() { write(path_compressed, FileStream_Compressed); });
+        measure("FileStream read, compressed (MB)",   [&]() { read(path_compressed, 0); });
+        FileStream::SetThreading(nullptr);
+    }
+}
+
+// Counts the allocations of the whole program (the runtime is linked statically), only while the benchmarks ask for it
+void* operator new(size_t size)
+{
+    if (_Benchmark::allocations_counting.load(memory_order_relaxed))
+    {
+        _Benchmark::allocation_count.fetch_add(1, memory_order_relaxed);
+    }
+
+    if (void* memory = malloc(size != 0 ? size : 1))
+        return memory;
+
+    throw bad_alloc();
+}
+
+void operator delete(void* memory) noexcept                 { free(memory); }
+void operator delete(void* memory, size_t) noexcept         { free(memory); }
+
+int main()
+{
+    Context context;
+    context.RegisterSubsystem<Threading>();
+    context.RegisterSubsystem<ResourceCache>();
+    context.RegisterSubsystem<World>(); // not initialized, so it starts out empty (no camera, light, etc.)
+    Threading* threading    = context.GetSubsystem<Threading>();
+    World* world            = context.GetSubsystem<World>();
+
+    FileSystem::CreateDirectory_(_Benchmark::directory);
+
+    _Benchmark::tasks(&context);
+    _Benchmark::loops(threading);
+    _Benchmark::events();
+    _Benchmark::cache(&context, threading);
+    _Benchmark::components(world);
+    _Benchmark::transforms(world);
+    _Benchmark::world_io(world);
+    _Benchmark::file_io(threading);
+
+    FileSystem::Delete(_Benchmark::directory);
+    return 0;
+}
@@ -85,6 +85,9 @@ void Editor::OnWindowMessage(WindowData& window_data)
         m_renderer      = m_context->GetSubsystem<Renderer>();
         m_profiler      = m_context->GetSubsystem<Profiler>();
         m_rhi_device    = m_renderer->GetRhiDevice();
+
+        // Pick up edited source images while the editor is running
+        m_context->GetSubsystem<ResourceCache>()->SetHotReload(true);
         
         if (m_renderer->IsInitialized())
         {
@@ -65,7 +65,7 @@ public:
 		g_threading->AddTask([resource_cache, file_path]()
 		{
 			resource_cache->Load<Spartan::Model>(file_path);
-		});
+		}, Spartan::Task_Background);
 	}
 
 	void LoadWorld(const std::string& file_path) const
@@ -76,10 +76,7 @@ public:
         g_threading->Flush(true);
 
 		// Load the scene asynchronously
-		g_threading->AddTask([world, file_path]()
-		{
-			world->LoadFromFile(file_path);
-		});
+		world->LoadFromFileAsync(file_path);
 	}
 
 	void SaveWorld(const std::string& file_path) const
@@ -90,7 +87,7 @@ public:
 		g_threading->AddTask([world, file_path]()
 		{
 			world->SaveToFile(file_path);
-		});
+		}, Spartan::Task_Background);
 	}
 
 	void PickEntity()
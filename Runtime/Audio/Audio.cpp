@@ -41,13 +41,14 @@ namespace Spartan
 {
     Audio::Audio(Context* context) : ISubsystem(context)
     {
-
+        // Uses a snapshot of the listener (taken while the world ticks), can tick on any thread alongside physics once the timer has ticked
+        SetTickDependencies(SubsystemData_Time | SubsystemData_Profiling, SubsystemData_Audio);
     }
 
 	Audio::~Audio()
 	{
 		// Unsubscribe from events
-		UNSUBSCRIBE_FROM_EVENT(Event_World_Unload, [this](Variant) { m_listener = nullptr; });
+		UNSUBSCRIBE_FROM_EVENT(m_event_world_unload);
 
 		if (!m_system_fmod)
 			return;
@@ -132,7 +133,7 @@ namespace Spartan
         m_profiler = m_context->GetSubsystem<Profiler>();
 
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(Event_World_Unload, [this](Variant) { m_listener = nullptr; });
+        m_event_world_unload = SUBSCRIBE_TO_EVENT(Event_World_Unload, [this](Variant) { m_listener_set = false; });
    
         return true;
     }
@@ -156,12 +157,12 @@ namespace Spartan
 			return;
 		}
 
-		if (m_listener)
+		if (m_listener_set)
 		{
-			auto position = m_listener->GetPosition();
+			auto position = m_listener_position;
 			auto velocity = Math::Vector3::Zero;
-			auto forward = m_listener->GetForward();
-			auto up = m_listener->GetUp();
+			auto forward = m_listener_forward;
+			auto up = m_listener_up;
 
 			// Set 3D attributes
 			m_result_fmod = m_system_fmod->set3DListenerAttributes(
@@ -181,7 +182,14 @@ namespace Spartan
 
     void Audio::SetListenerTransform(Transform* transform)
 	{
-		m_listener = transform;
+        // The world and audio tick in different groups, so they never run at the same time
+        m_listener_set = transform != nullptr;
+        if (!transform)
+            return;
+
+        m_listener_position = transform->GetPosition();
+        m_listener_forward  = transform->GetForward();
+        m_listener_up       = transform->GetUp();
 	}
 
 	void Audio::LogErrorFmod(int error) const
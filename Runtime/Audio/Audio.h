@@ -23,6 +23,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include "../Core/ISubsystem.h"
+#include "../Core/EventSystem.h"
+#include "../Math/Vector3.h"
 //=============================
 
 //= FORWARD DECLARATIONS =
@@ -49,6 +51,7 @@ namespace Spartan
         //===================================
 
 		auto GetSystemFMOD() const { return m_system_fmod; }
+		// Takes a snapshot of the listener, the world sets it while ticking so audio never reads the world
 		void SetListenerTransform(Transform* transform);
 
 	private:
@@ -58,8 +61,12 @@ namespace Spartan
 		uint32_t m_max_channels		= 32;
 		float m_distance_entity		= 1.0f;
 		bool m_initialized			= false;
-		Transform* m_listener		= nullptr;
+		bool m_listener_set                 = false;
+		Math::Vector3 m_listener_position   = Math::Vector3::Zero;
+		Math::Vector3 m_listener_forward    = Math::Vector3::Forward;
+		Math::Vector3 m_listener_up         = Math::Vector3::Up;
 		Profiler* m_profiler		= nullptr;
 		FMOD::System* m_system_fmod = nullptr;
+        EventHandle m_event_world_unload;
 	};
 }
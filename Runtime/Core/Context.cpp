@@ -0,0 +1,223 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ====================
+#include "Context.h"
+#include "../Threading/Threading.h"
+//===============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    void Context::Tick(const Tick_Group tick_group, const float delta_time /*= 0.0f*/)
+    {
+        if (m_tick_graph_dirty)
+        {
+            BuildTickGraph();
+        }
+
+        vector<TickNode>& graph         = m_tick_graph[tick_group];
+        vector<TickNodeState>& states   = m_tick_states[tick_group];
+        const uint32_t node_count       = static_cast<uint32_t>(graph.size());
+        if (node_count == 0)
+            return;
+
+        // Without worker threads, everything ticks on this thread (in registration order)
+        Threading* threading = GetSubsystem<Threading>();
+        if (threading && threading->GetThreadCount() == 0)
+        {
+            threading = nullptr;
+        }
+
+        m_tick_timer.Start();
+        m_tick_nodes_done = 0;
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            states[i].dependencies_remaining    = static_cast<uint32_t>(graph[i].dependencies.size());
+            states[i].ready                     = false;
+        }
+
+        // Kick off the subsystems which don't depend on anything, the rest are kicked off as their dependencies finish
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            if (graph[i].dependencies.empty())
+            {
+                TickSchedule(tick_group, i, delta_time, threading);
+            }
+        }
+
+        while (m_tick_nodes_done.load() != node_count)
+        {
+            // Main thread subsystems tick in registration order
+            bool ticked = false;
+            for (uint32_t i = 0; i < node_count && !ticked; i++)
+            {
+                if (states[i].ready.load() && states[i].ready.exchange(false))
+                {
+                    TickSubsystem(tick_group, i, delta_time, threading);
+                    ticked = true;
+                }
+            }
+
+            // Otherwise help out with the critical work (e.g. other subsystems' ticks), anything longer could stall the frame
+            if (!ticked && (!threading || !threading->TaskExecuteNext(Task_Critical)))
+            {
+                this_thread::yield();
+            }
+        }
+
+        UpdateTickReport(tick_group, m_tick_timer.GetElapsedTimeMs());
+    }
+
+    void Context::BuildTickGraph()
+    {
+        // Two subsystems conflict if either writes something the other one reads or writes
+        const auto conflict = [](const ISubsystem* a, const ISubsystem* b)
+        {
+            return (a->GetTickWrites() & (b->GetTickReads() | b->GetTickWrites())) || (b->GetTickWrites() & a->GetTickReads());
+        };
+
+        for (uint32_t group = 0; group < 2; group++)
+        {
+            vector<TickNode>& graph = m_tick_graph[group];
+            graph.clear();
+
+            for (const auto& subsystem : m_subsystems)
+            {
+                if (subsystem.tick_group != static_cast<Tick_Group>(group))
+                    continue;
+
+                TickNode& node  = graph.emplace_back();
+                node.subsystem  = subsystem.ptr.get();
+
+                // Strip the "class Spartan::" part of the type name
+                node.name = typeid(*node.subsystem).name();
+                node.name = node.name.substr(node.name.find_last_of(": ") + 1);
+
+                // A subsystem depends on any conflicting subsystem that was registered before it, this preserves
+                // the registration order where it matters (e.g. the Timer ticking first and the Renderer last)
+                const uint32_t index = static_cast<uint32_t>(graph.size() - 1);
+                for (uint32_t i = 0; i < index; i++)
+                {
+                    if (conflict(graph[i].subsystem, node.subsystem))
+                    {
+                        node.dependencies.emplace_back(i);
+                        graph[i].dependents.emplace_back(index);
+                    }
+                }
+            }
+
+            m_tick_states[group] = vector<TickNodeState>(graph.size());
+        }
+
+        m_tick_graph_dirty = false;
+    }
+
+    void Context::TickSchedule(const Tick_Group tick_group, const uint32_t node_index, const float delta_time, Threading* threading)
+    {
+        if (!threading || m_tick_graph[tick_group][node_index].subsystem->GetTickMainThread())
+        {
+            m_tick_states[tick_group][node_index].ready = true;
+            return;
+        }
+
+        threading->AddTask([this, tick_group, node_index, delta_time, threading]()
+        {
+            TickSubsystem(tick_group, node_index, delta_time, threading);
+        }, Task_Critical);
+    }
+
+    void Context::TickSubsystem(const Tick_Group tick_group, const uint32_t node_index, const float delta_time, Threading* threading)
+    {
+        const TickNode& node    = m_tick_graph[tick_group][node_index];
+        TickNodeState& state    = m_tick_states[tick_group][node_index];
+
+        state.start_ms = m_tick_timer.GetElapsedTimeMs();
+        node.subsystem->Tick(delta_time);
+        state.duration_ms = m_tick_timer.GetElapsedTimeMs() - state.start_ms;
+
+        // Kick off any dependents which were only waiting for this subsystem
+        for (const uint32_t dependent : node.dependents)
+        {
+            if (m_tick_states[tick_group][dependent].dependencies_remaining.fetch_sub(1) == 1)
+            {
+                TickSchedule(tick_group, dependent, delta_time, threading);
+            }
+        }
+
+        m_tick_nodes_done++;
+    }
+
+    void Context::UpdateTickReport(const Tick_Group tick_group, const float duration_ms)
+    {
+        const vector<TickNode>& graph   = m_tick_graph[tick_group];
+        vector<TickNodeState>& states   = m_tick_states[tick_group];
+        TickReport& report              = m_tick_reports[tick_group];
+        const uint32_t node_count       = static_cast<uint32_t>(graph.size());
+
+        // Dependencies always come before their dependents, so a single pass finds the longest chain ending at each node
+        uint32_t path_end = 0;
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            TickNodeState& state    = states[i];
+            state.path_ms           = 0.0f;
+            state.path_previous     = i;
+
+            for (const uint32_t dependency : graph[i].dependencies)
+            {
+                if (states[dependency].path_ms > state.path_ms)
+                {
+                    state.path_ms       = states[dependency].path_ms;
+                    state.path_previous = dependency;
+                }
+            }
+            state.path_ms += state.duration_ms;
+
+            path_end = state.path_ms > states[path_end].path_ms ? i : path_end;
+        }
+
+        report.subsystems.resize(node_count);
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            SubsystemTiming& timing = report.subsystems[i];
+            timing.name             = graph[i].name;
+            timing.start_ms         = states[i].start_ms;
+            timing.duration_ms      = states[i].duration_ms;
+            timing.on_critical_path = false;
+        }
+
+        // Walk the critical path backwards
+        for (uint32_t i = path_end; ; i = states[i].path_previous)
+        {
+            report.subsystems[i].on_critical_path = true;
+
+            if (states[i].path_previous == i)
+                break;
+        }
+
+        report.critical_path_ms = states[path_end].path_ms;
+        report.duration_ms      = duration_ms;
+    }
+}
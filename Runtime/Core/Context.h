@@ -22,14 +22,18 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES ==============
+#include <vector>
+#include <atomic>
 #include "EngineDefs.h"
 #include "ISubsystem.h"
+#include "Stopwatch.h"
 #include "../Logging/Log.h"
 //=========================
 
 namespace Spartan
 {
     class Engine;
+    class Threading;
 
     enum Tick_Group
     {
@@ -49,6 +53,22 @@ namespace Spartan
         Tick_Group tick_group;
     };
 
+    // How long a subsystem ticked for, relative to the start of its tick group
+    struct SubsystemTiming
+    {
+        std::string name;
+        float start_ms          = 0.0f;
+        float duration_ms       = 0.0f;
+        bool on_critical_path   = false;
+    };
+
+    struct TickReport
+    {
+        std::vector<SubsystemTiming> subsystems;
+        float critical_path_ms  = 0.0f; // the longest dependency chain, the lower bound of the group's tick time
+        float duration_ms       = 0.0f; // the actual time it took for the group to tick
+    };
+
 	class SPARTAN_CLASS Context
 	{
 	public:
@@ -72,6 +92,7 @@ namespace Spartan
             validate_subsystem_type<T>();
 
             m_subsystems.emplace_back(std::make_shared<T>(this), tick_group);
+            m_tick_graph_dirty = true;
 		}
 
 		// Initialize subsystems
@@ -90,17 +111,11 @@ namespace Spartan
 			return result;
 		}
 
-        // Tick
-		void Tick(Tick_Group tick_group, float delta_time = 0.0f)
-		{
-            for (const auto& subsystem : m_subsystems)
-            {
-                if (subsystem.tick_group != tick_group)
-                    continue;
+        // Ticks the subsystems of a group, subsystems that don't depend on each other tick in parallel
+		void Tick(Tick_Group tick_group, float delta_time = 0.0f);
 
-                subsystem.ptr->Tick(delta_time);
-            }
-		}
+        // Timings and critical path of the last tick of a group
+        const TickReport& GetTickReport(Tick_Group tick_group) const { return m_tick_reports[tick_group]; }
 
 		// Get a subsystem
 		template <class T> 
@@ -120,6 +135,39 @@ namespace Spartan
         Engine* m_engine = nullptr;
 
 	private:
+        // A subsystem in a tick group's dependency graph
+        struct TickNode
+        {
+            ISubsystem* subsystem = nullptr;
+            std::string name;
+            std::vector<uint32_t> dependencies; // nodes that have to tick before this one
+            std::vector<uint32_t> dependents;   // nodes that wait for this one
+        };
+
+        // Per tick state of a node
+        struct TickNodeState
+        {
+            std::atomic<uint32_t> dependencies_remaining    = 0;
+            std::atomic<bool> ready                         = false;
+            float start_ms                                  = 0.0f;
+            float duration_ms                               = 0.0f;
+            float path_ms                                   = 0.0f; // longest chain of ticks which ends with this node
+            uint32_t path_previous                          = 0;
+        };
+
+        void BuildTickGraph();
+        void TickSchedule(Tick_Group tick_group, uint32_t node_index, float delta_time, Threading* threading);
+        void TickSubsystem(Tick_Group tick_group, uint32_t node_index, float delta_time, Threading* threading);
+        void UpdateTickReport(Tick_Group tick_group, float duration_ms);
+
 		std::vector<_subystem> m_subsystems;
+
+        // Tick graph (one per tick group)
+        std::vector<TickNode> m_tick_graph[2];
+        std::vector<TickNodeState> m_tick_states[2];
+        TickReport m_tick_reports[2];
+        std::atomic<uint32_t> m_tick_nodes_done = 0;
+        bool m_tick_graph_dirty                 = true;
+        Stopwatch m_tick_timer;
 	};
 }
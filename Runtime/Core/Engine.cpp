@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Settings.h"
 #include "../Audio/Audio.h"
 #include "../Input/Input.h"
+#include "../IO/FileStream.h"
 #include "../Physics/Physics.h"
 #include "../Profiling/Profiler.h"
 #include "../Rendering/Renderer.h"
@@ -71,11 +72,15 @@ namespace Spartan
 		// Initialize above subsystems
 		m_context->Initialize();
 
+        // Let compressed files decode in parallel
+        FileStream::SetThreading(m_context->GetSubsystem<Threading>());
+
         m_timer = m_context->GetSubsystem<Timer>();
 	}
 
 	Engine::~Engine()
 	{
+        FileStream::SetThreading(nullptr);
 		EventSystem::Get().Clear(); // this must become a subsystem
 	}
 
@@ -83,6 +88,11 @@ namespace Spartan
     {
         m_context->Tick(Tick_Variable, static_cast<float>(m_timer->GetDeltaTimeSec()));
         m_context->Tick(Tick_Smoothed, static_cast<float>(m_timer->GetDeltaTimeSmoothedSec()));
+
+        // Deliver the events which were fired during the frame
+        EventSystem::Get().ProcessDeferred();
+
+        FIRE_EVENT(Event_Frame_End);
 	}
 
     void Engine::SetWindowData(WindowData& window_data)
@@ -25,18 +25,26 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <unordered_map>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
 #include "../Core/Variant.h"
 //==========================
 
 /*
 HOW TO USE
 =================================================================================
-To subscribe a function to an event		-> SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
-To unsubscribe a function from an event	-> SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
+To subscribe a function to an event		-> EventHandle handle = SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
+To subscribe a function pointer			-> EventHandle handle = SUBSCRIBE_TO_EVENT_RAW(EVENT_ID, EVENT_HANDLER_RAW(Class, Function), this);
+To unsubscribe a function from an event	-> UNSUBSCRIBE_FROM_EVENT(handle);
 To fire an event						-> FIRE_EVENT(EVENT_ID);
 To fire an event with data				-> FIRE_EVENT_DATA(EVENT_ID, Variant);
+To fire an event at the end of the frame	-> FIRE_EVENT_DEFERRED(EVENT_ID);
+To fire it with data					-> FIRE_EVENT_DEFERRED_DATA(EVENT_ID, Variant);
 
-Note: Currently, this is a blocking event system
+Note: Firing is thread-safe. Immediate events run the subscribers on the calling thread,
+deferred events run them on the main thread, when the engine processes them at the end of the frame.
+Data is passed to the subscribers by reference, move it in (or pass a pointer to it, immediate events only) to avoid copies.
 =================================================================================
 */
 
@@ -53,7 +61,9 @@ enum Event_Type
 	Event_World_Resolve_Complete,	// The world has finished resolving
 	Event_World_Stop,		        // The world should stop ticking
 	Event_World_Start,		        // The world should start ticking
-    Event_Frame_Resolution_Changed
+    Event_Frame_Resolution_Changed,
+    Event_Material_Transparency_Changed, // A material switched between opaque and transparent
+    Event_Count                     // Not an event, the number of events
 };
 
 //= MACROS ====================================================================================================
@@ -66,16 +76,38 @@ enum Event_Type
 #define EVENT_HANDLER_VARIANT(function)				[this](const Spartan::Variant& var)	{ function(var); }
 #define EVENT_HANDLER_VARIANT_STATIC(function)		[](const Spartan::Variant& var)		{ function(var); }
 
+#define EVENT_HANDLER_RAW(type, function)			[](void* context, const Spartan::Variant& var) { static_cast<type*>(context)->function(); }
+
 #define FIRE_EVENT(eventID)							Spartan::EventSystem::Get().Fire(eventID)
 #define FIRE_EVENT_DATA(eventID, data)				Spartan::EventSystem::Get().Fire(eventID, data)
+#define FIRE_EVENT_DEFERRED(eventID)				Spartan::EventSystem::Get().FireDeferred(eventID)
+#define FIRE_EVENT_DEFERRED_DATA(eventID, data)		Spartan::EventSystem::Get().FireDeferred(eventID, data)
 
-#define SUBSCRIBE_TO_EVENT(eventID, function)		Spartan::EventSystem::Get().Subscribe(eventID, function);
-#define UNSUBSCRIBE_FROM_EVENT(eventID, function)	Spartan::EventSystem::Get().Unsubscribe(eventID, function);
+#define SUBSCRIBE_TO_EVENT(eventID, function)		Spartan::EventSystem::Get().Subscribe(eventID, function)
+#define SUBSCRIBE_TO_EVENT_RAW(eventID, function, context)	Spartan::EventSystem::Get().Subscribe(eventID, function, context)
+#define UNSUBSCRIBE_FROM_EVENT(handle)				Spartan::EventSystem::Get().Unsubscribe(handle)
 //=============================================================================================================
 
 namespace Spartan
 {
-	using subscriber = std::function<void(const Variant&)>;
+	using subscriber        = std::function<void(const Variant&)>;
+    using subscriber_raw    = void (*)(void* context, const Variant& data);
+
+    // Identifies a subscription, unsubscribing through it is O(1)
+    class EventHandle
+    {
+    public:
+        EventHandle() = default;
+        EventHandle(const Event_Type event_id, const uint32_t id) { m_event_id = event_id; m_id = id; }
+
+        bool IsValid() const { return m_id != 0; }
+
+    private:
+        friend class EventSystem;
+
+        Event_Type m_event_id   = Event_Frame_End;
+        uint32_t m_id           = 0;
+    };
 
 	class SPARTAN_CLASS EventSystem
 	{
@@ -86,44 +118,257 @@ namespace Spartan
 			return instance;
 		}
 
-		void Subscribe(const Event_Type event_id, subscriber&& function)
+        ~EventSystem() { Clear(); }
+
+		EventHandle Subscribe(const Event_Type event_id, subscriber&& function)
 		{
-			m_subscribers[event_id].push_back(std::forward<subscriber>(function));
+            // The function object is the context of a trampoline, so both kinds of subscribers are called the same way
+            auto owned          = std::make_unique<subscriber>(std::forward<subscriber>(function));
+            subscriber* context = owned.get();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const EventHandle handle = SubscribeInternal(event_id, [](void* context, const Variant& data) { (*static_cast<subscriber*>(context))(data); }, context);
+            m_events[event_id].functions[handle.m_id] = std::move(owned);
+
+            return handle;
 		}
 
-		void Unsubscribe(const Event_Type event_id, subscriber&& function)
+        // Subscribes a function pointer which is passed the context, firing it doesn't have to go through a std::function
+        EventHandle Subscribe(const Event_Type event_id, subscriber_raw function, void* context)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return SubscribeInternal(event_id, function, context);
+        }
+
+		void Unsubscribe(const EventHandle& handle)
 		{
-			const size_t function_adress	= *reinterpret_cast<long*>(reinterpret_cast<char*>(&function));
-			auto& subscribers				= m_subscribers[event_id];
-
-			for (auto it = subscribers.begin(); it != subscribers.end();)
-			{
-				const size_t subscriber_adress = *reinterpret_cast<long*>(reinterpret_cast<char*>(&(*it)));
-				if (subscriber_adress == function_adress)
-				{
-					it = subscribers.erase(it);
-					return;
-				}
-			}
+            if (!handle.IsValid())
+                return;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            Event& event    = m_events[handle.m_event_id];
+            auto it         = event.positions.find(handle.m_id);
+            if (it == event.positions.end())
+                return;
+
+            // Leave a hole which firing skips, the list is compacted at the end of the frame
+            event.subscribers.load(std::memory_order_relaxed)->subscribers[it->second].function.store(nullptr, std::memory_order_release);
+            event.positions.erase(it);
+            event.holes++;
+
+            // A thread which is firing the event might still be calling the function object
+            auto it_function = event.functions.find(handle.m_id);
+            if (it_function != event.functions.end())
+            {
+                m_retired_functions.emplace_back(std::move(it_function->second));
+                event.functions.erase(it_function);
+            }
 		}
 
+        // Runs the subscribers on the calling thread, right away
 		void Fire(const Event_Type event_id, const Variant& data = 0)
 		{
-			if (m_subscribers.find(event_id) == m_subscribers.end())
-				return;
+            // Lists which are replaced while a thread is firing are only freed once no thread is firing
+            m_firing.fetch_add(1);
+
+            if (const SubscriberList* list = m_events[event_id].subscribers.load())
+            {
+                for (uint32_t i = 0; i < list->count; i++)
+                {
+                    const Subscriber& subscriber = list->subscribers[i];
+                    if (subscriber_raw function = subscriber.function.load(std::memory_order_acquire))
+                    {
+                        function(subscriber.context, data);
+                    }
+                }
+            }
 
-			for (const auto& subscriber : m_subscribers[event_id])
-			{
-				subscriber(data);
-			}
+            m_firing.fetch_sub(1);
 		}
 
+        // Queues the event without locking, the subscribers run when ProcessDeferred() is called
+        void FireDeferred(const Event_Type event_id, Variant data = 0)
+        {
+            EventDeferred* event    = new EventDeferred();
+            event->event_id         = event_id;
+            event->data             = std::move(data);
+            event->next             = m_deferred.load(std::memory_order_relaxed);
+
+            while (!m_deferred.compare_exchange_weak(event->next, event, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // Fires the deferred events in the order they were queued, events queued by the subscribers wait for the next call.
+        // This is also where unsubscribed holes are compacted and replaced subscriber lists are freed.
+        void ProcessDeferred()
+        {
+            EventDeferred* event = m_deferred.exchange(nullptr, std::memory_order_acquire);
+
+            // The queue is a stack, so reverse it
+            EventDeferred* event_first = nullptr;
+            while (event)
+            {
+                EventDeferred* next = event->next;
+                event->next         = event_first;
+                event_first         = event;
+                event               = next;
+            }
+
+            while (event_first)
+            {
+                EventDeferred* next = event_first->next;
+                Fire(event_first->event_id, event_first->data);
+                delete event_first;
+                event_first = next;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for (uint32_t event_id = 0; event_id < Event_Count; event_id++)
+            {
+                if (m_events[event_id].holes != 0)
+                {
+                    Rebuild(static_cast<Event_Type>(event_id), nullptr, nullptr, 0);
+                }
+            }
+
+            Reclaim();
+        }
+
 		void Clear() 
 		{
-			m_subscribers.clear(); 
+            // Events which are still queued have nobody to go to
+            EventDeferred* event = m_deferred.exchange(nullptr, std::memory_order_acquire);
+            while (event)
+            {
+                EventDeferred* next = event->next;
+                delete event;
+                event = next;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for (Event& event : m_events)
+            {
+                if (SubscriberList* list = event.subscribers.exchange(nullptr))
+                {
+                    m_retired_lists.emplace_back(list);
+                }
+
+                for (auto& it : event.functions)
+                {
+                    m_retired_functions.emplace_back(std::move(it.second));
+                }
+
+                event.functions.clear();
+                event.positions.clear();
+                event.holes = 0;
+            }
+
+            Reclaim();
 		}
 
 	private:
-		std::unordered_map<Event_Type, std::vector<subscriber>> m_subscribers;
+        struct Subscriber
+        {
+            std::atomic<subscriber_raw> function    = nullptr;
+            void* context                           = nullptr;
+            uint32_t id                             = 0;
+        };
+
+        // Never modified once published, other than unsubscribed functions being set to null
+        struct SubscriberList
+        {
+            uint32_t count = 0;
+            std::unique_ptr<Subscriber[]> subscribers;
+        };
+
+        struct Event
+        {
+            std::atomic<SubscriberList*> subscribers = nullptr;
+            std::unordered_map<uint32_t, uint32_t> positions; // subscription id to index in the list
+            std::unordered_map<uint32_t, std::unique_ptr<subscriber>> functions;
+            uint32_t holes = 0;
+        };
+
+        struct EventDeferred
+        {
+            Event_Type event_id     = Event_Frame_End;
+            Variant data;
+            EventDeferred* next     = nullptr;
+        };
+
+        EventHandle SubscribeInternal(const Event_Type event_id, subscriber_raw function, void* context)
+        {
+            const uint32_t id = ++m_id;
+            Rebuild(event_id, function, context, id);
+            return EventHandle(event_id, id);
+        }
+
+        // Publishes a new list without the holes and with the new subscriber (if any), the old list is retired
+        void Rebuild(const Event_Type event_id, subscriber_raw function, void* context, const uint32_t id)
+        {
+            Event& event                    = m_events[event_id];
+            SubscriberList* list_previous   = event.subscribers.load(std::memory_order_relaxed);
+            const uint32_t count_previous   = list_previous ? list_previous->count : 0;
+
+            SubscriberList* list    = new SubscriberList();
+            list->subscribers       = std::make_unique<Subscriber[]>(count_previous - event.holes + (function ? 1 : 0));
+            event.positions.clear();
+
+            auto add = [&list, &event](subscriber_raw function, void* context, const uint32_t id)
+            {
+                Subscriber& subscriber = list->subscribers[list->count];
+                subscriber.function.store(function, std::memory_order_relaxed);
+                subscriber.context  = context;
+                subscriber.id       = id;
+                event.positions[id] = list->count++;
+            };
+
+            for (uint32_t i = 0; i < count_previous; i++)
+            {
+                const Subscriber& subscriber = list_previous->subscribers[i];
+                if (subscriber_raw function_previous = subscriber.function.load(std::memory_order_relaxed))
+                {
+                    add(function_previous, subscriber.context, subscriber.id);
+                }
+            }
+
+            if (function)
+            {
+                add(function, context, id);
+            }
+
+            // Sequentially consistent, so that Reclaim() can't miss a thread that is about to read the previous list
+            event.holes = 0;
+            event.subscribers.store(list);
+
+            if (list_previous)
+            {
+                m_retired_lists.emplace_back(list_previous);
+            }
+        }
+
+        // Frees retired lists and function objects, but only if no thread can still be reading them
+        void Reclaim()
+        {
+            if (m_firing.load() != 0)
+                return;
+
+            for (SubscriberList* list : m_retired_lists)
+            {
+                delete list;
+            }
+            m_retired_lists.clear();
+            m_retired_functions.clear();
+        }
+
+        Event m_events[Event_Count];
+        std::vector<SubscriberList*> m_retired_lists;
+        std::vector<std::unique_ptr<subscriber>> m_retired_functions;
+        std::atomic<uint32_t> m_firing = 0;
+        uint32_t m_id = 0;
+        std::mutex m_mutex;
+        std::atomic<EventDeferred*> m_deferred = nullptr;
 	};
 }
@@ -25,7 +25,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <regex>
 #include <fstream>
 #include <sstream> 
+#include <shared_mutex>
+#include <thread>
+#include <chrono>
+#include <unordered_map>
 #include "../Logging/Log.h"
+#include "../IO/Archive.h"
 #include <Windows.h>
 #include <shellapi.h>
 //=========================
@@ -36,6 +41,37 @@ using namespace std;
 
 namespace Spartan
 {
+    // Mounted archives, the most recently mounted one is searched first
+    static vector<shared_ptr<Archive>> archives;
+    static shared_mutex archives_mutex;
+    static bool archives_loose_override = true;
+
+    // Watched directories, changed files (relative to the working directory) and when they last changed
+    struct DirectoryWatch
+    {
+        HANDLE handle   = INVALID_HANDLE_VALUE;
+        HANDLE stop     = nullptr; // signaled to end the watch
+        string path; // prefix for the changed files, relative to the working directory
+        thread thread;
+    };
+    static vector<unique_ptr<DirectoryWatch>> watches;
+    static mutex watches_mutex;
+    static unordered_map<string, chrono::steady_clock::time_point> watch_changes;
+    static mutex watch_changes_mutex;
+
+    static shared_ptr<Archive> find_in_archives(const string& path, const std::byte** data, uint64_t* size)
+    {
+        shared_lock<shared_mutex> lock(archives_mutex);
+
+        for (auto it = archives.rbegin(); it != archives.rend(); it++)
+        {
+            if ((*it)->Find(path, data, size))
+                return *it;
+        }
+
+        return nullptr;
+    }
+
     bool FileSystem::IsEmptyOrWhitespace(const std::string& var)
     {
         // Check if it's empty
@@ -247,6 +283,9 @@ namespace Spartan
 
     bool FileSystem::Exists(const string& path)
     {
+        if (find_in_archives(path, nullptr, nullptr))
+            return true;
+
         try
         {
             if (filesystem::exists(path))
@@ -280,6 +319,9 @@ namespace Spartan
         if (path.empty())
             return false;
 
+        if (find_in_archives(path, nullptr, nullptr))
+            return true;
+
         try
         {
             if (filesystem::exists(path) && filesystem::is_regular_file(path))
@@ -293,6 +335,18 @@ namespace Spartan
         return false;
     }
 
+    uint64_t FileSystem::GetFileSize(const string& path)
+    {
+        const std::byte* data = nullptr;
+        uint64_t size = 0;
+        if (find_in_archives(path, &data, &size))
+            return size;
+
+        error_code error;
+        const uintmax_t file_size = filesystem::file_size(path, error);
+        return error ? 0 : static_cast<uint64_t>(file_size);
+    }
+
 	bool FileSystem::CopyFileFromTo(const string& source, const string& destination)
 	{
 		if (source == destination)
@@ -739,4 +793,167 @@ namespace Spartan
     {
         return filesystem::path(path).root_directory().generic_string();
     }
+
+    bool FileSystem::MountArchive(const string& path)
+    {
+        auto archive = make_shared<Archive>();
+        if (!archive->Mount(path))
+            return false;
+
+        unique_lock<shared_mutex> lock(archives_mutex);
+        archives.emplace_back(archive);
+        LOG_INFO("Mounted \"%s\" (%d files)", path.c_str(), archive->GetEntryCount());
+
+        return true;
+    }
+
+    void FileSystem::UnmountArchives()
+    {
+        // Streams which are reading from an archive keep it mapped until they are done
+        unique_lock<shared_mutex> lock(archives_mutex);
+        archives.clear();
+    }
+
+    shared_ptr<Archive> FileSystem::FindInArchives(const string& path, const std::byte** data, uint64_t* size)
+    {
+        shared_ptr<Archive> archive = find_in_archives(path, data, size);
+        if (!archive || !archives_loose_override)
+            return archive;
+
+        // A loose file takes precedence
+        error_code error;
+        return filesystem::is_regular_file(path, error) ? nullptr : archive;
+    }
+
+    void FileSystem::SetLooseFilesOverrideArchives(const bool override)
+    {
+        archives_loose_override = override;
+    }
+
+    bool FileSystem::WatchDirectory(const string& path)
+    {
+        auto watch      = make_unique<DirectoryWatch>();
+        watch->path     = GetRelativePath(path);
+        watch->path     = (watch->path.empty() || watch->path == ".") ? "" : watch->path + "/";
+        watch->handle   = CreateFileW(StringToWstring(path).c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (watch->handle == INVALID_HANDLE_VALUE)
+        {
+            LOG_ERROR("Failed to watch \"%s\"", path.c_str());
+            return false;
+        }
+
+        watch->stop = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!watch->stop)
+        {
+            LOG_ERROR("Failed to watch \"%s\"", path.c_str());
+            CloseHandle(watch->handle);
+            return false;
+        }
+
+        // Waits until something changes or until UnwatchDirectories() signals the stop event, the reads are
+        // overlapped as a synchronous one can't be reliably cancelled from another thread.
+        DirectoryWatch* watch_ptr = watch.get();
+        watch->thread = thread([watch_ptr]()
+        {
+            alignas(DWORD) char buffer[64 * 1024];
+            const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+
+            OVERLAPPED overlapped   = {};
+            overlapped.hEvent       = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+            if (!overlapped.hEvent)
+                return;
+
+            while (true)
+            {
+                ResetEvent(overlapped.hEvent);
+                if (!ReadDirectoryChangesW(watch_ptr->handle, buffer, sizeof(buffer), TRUE, filter, nullptr, &overlapped, nullptr))
+                    break;
+
+                const HANDLE events[] = { overlapped.hEvent, watch_ptr->stop };
+                DWORD bytes = 0;
+                if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0)
+                {
+                    // The buffer is on this stack, so the read has to be done before leaving
+                    CancelIoEx(watch_ptr->handle, &overlapped);
+                    GetOverlappedResult(watch_ptr->handle, &overlapped, &bytes, TRUE);
+                    break;
+                }
+
+                if (!GetOverlappedResult(watch_ptr->handle, &overlapped, &bytes, FALSE))
+                    break;
+
+                // The buffer overflowed, the changes are lost
+                if (bytes == 0)
+                    continue;
+
+                const auto now = chrono::steady_clock::now();
+                lock_guard<mutex> lock(watch_changes_mutex);
+
+                const char* it = buffer;
+                while (true)
+                {
+                    const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(it);
+                    if (info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME)
+                    {
+                        const int name_length = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+                        string name(WideCharToMultiByte(CP_UTF8, 0, info->FileName, name_length, nullptr, 0, nullptr, nullptr), 0);
+                        WideCharToMultiByte(CP_UTF8, 0, info->FileName, name_length, name.data(), static_cast<int>(name.size()), nullptr, nullptr);
+                        replace(name.begin(), name.end(), '\\', '/');
+
+                        watch_changes[watch_ptr->path + name] = now;
+                    }
+
+                    if (info->NextEntryOffset == 0)
+                        break;
+
+                    it += info->NextEntryOffset;
+                }
+            }
+
+            CloseHandle(overlapped.hEvent);
+        });
+
+        lock_guard<mutex> lock(watches_mutex);
+        watches.emplace_back(move(watch));
+
+        return true;
+    }
+
+    void FileSystem::UnwatchDirectories()
+    {
+        lock_guard<mutex> lock(watches_mutex);
+
+        for (unique_ptr<DirectoryWatch>& watch : watches)
+        {
+            SetEvent(watch->stop);
+            watch->thread.join();
+            CloseHandle(watch->stop);
+            CloseHandle(watch->handle);
+        }
+        watches.clear();
+
+        lock_guard<mutex> lock_changes(watch_changes_mutex);
+        watch_changes.clear();
+    }
+
+    vector<string> FileSystem::GetChangedFiles(const uint32_t quiet_ms /*= 250*/)
+    {
+        vector<string> changed;
+        const auto now = chrono::steady_clock::now();
+
+        lock_guard<mutex> lock(watch_changes_mutex);
+        for (auto it = watch_changes.begin(); it != watch_changes.end();)
+        {
+            if (now - it->second < chrono::milliseconds(quiet_ms))
+            {
+                it++;
+                continue;
+            }
+
+            changed.emplace_back(it->first);
+            it = watch_changes.erase(it);
+        }
+
+        return changed;
+    }
 }
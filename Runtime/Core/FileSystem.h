@@ -24,11 +24,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ==================
 #include <vector>
 #include <string>
+#include <memory>
 #include "../Core/EngineDefs.h"
 //=============================
 
 namespace Spartan
 {
+    class Archive;
+
 	class SPARTAN_CLASS FileSystem
 	{
 	public:
@@ -51,6 +54,7 @@ namespace Spartan
 		static bool Exists(const std::string& path);
         static bool IsDirectory(const std::string& path);
         static bool IsFile(const std::string& path);
+        static uint64_t GetFileSize(const std::string& path);
 		static bool CopyFileFromTo(const std::string& source, const std::string& destination);
 		static std::string GetFileNameFromFilePath(const std::string& path);
 		static std::string GetFileNameNoExtensionFromFilePath(const std::string& path);
@@ -65,6 +69,18 @@ namespace Spartan
 		static std::vector<std::string> GetDirectoriesInDirectory(const std::string& path);
 		static std::vector<std::string> GetFilesInDirectory(const std::string& path);
 
+        // Archives, files inside mounted archives are visible to Exists(), IsFile() and FileStream
+        static bool MountArchive(const std::string& path);
+        static void UnmountArchives();
+        static std::shared_ptr<Archive> FindInArchives(const std::string& path, const std::byte** data, uint64_t* size);
+        static void SetLooseFilesOverrideArchives(bool override); // on by default, so that edited files are picked up during development
+
+        // File watching, a background thread collects changes and bursts of changes to the same file (editors often write a file
+        // more than once when saving) are reported once, after the file has been left alone for quiet_ms.
+        static bool WatchDirectory(const std::string& path);
+        static void UnwatchDirectories();
+        static std::vector<std::string> GetChangedFiles(uint32_t quiet_ms = 250);
+
         // Supported files
 		static bool IsSupportedAudioFile(const std::string& path);
 		static bool IsSupportedImageFile(const std::string& path);
@@ -101,6 +117,7 @@ namespace Spartan
     static const char* EXTENSION_TEXTURE   = ".texture";
     static const char* EXTENSION_MESH      = ".mesh";
     static const char* EXTENSION_AUDIO     = ".audio";
+    static const char* EXTENSION_ARCHIVE   = ".pak";
 
     static const std::vector<std::string> supported_formats_image
     {
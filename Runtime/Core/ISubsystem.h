@@ -31,6 +31,22 @@ namespace Spartan
 {
 	class Context;
 
+    // Data that a subsystem can access while ticking, subsystems with no conflicting access can tick in parallel
+    enum Subsystem_Data : uint32_t
+    {
+        SubsystemData_None      = 0,
+        SubsystemData_Time      = 1 << 0,
+        SubsystemData_Input     = 1 << 1,
+        SubsystemData_Audio     = 1 << 2,
+        SubsystemData_Physics   = 1 << 3,
+        SubsystemData_World     = 1 << 4,
+        SubsystemData_Resources = 1 << 5,
+        SubsystemData_Scripting = 1 << 6,
+        SubsystemData_Rendering = 1 << 7,
+        SubsystemData_Profiling = 1 << 8, // the profiler's frame, time blocks are recorded as reads and are thread safe
+        SubsystemData_All       = 0xFFFFFFFF
+    };
+
 	class SPARTAN_CLASS ISubsystem : public std::enable_shared_from_this<ISubsystem>
 	{		
 	public:
@@ -42,8 +58,26 @@ namespace Spartan
         template <typename T>
         std::shared_ptr<T> GetPtrShared() { return dynamic_pointer_cast<T>(shared_from_this()); }
 
+        // Tick dependencies
+        uint32_t GetTickReads()     const { return m_tick_reads; }
+        uint32_t GetTickWrites()    const { return m_tick_writes; }
+        bool GetTickMainThread()    const { return m_tick_main_thread; }
+
 	protected:
+        // Subsystems which don't declare what they access, read and write everything on the main thread, so they tick on their own
+        void SetTickDependencies(const uint32_t reads, const uint32_t writes, const bool main_thread = false)
+        {
+            m_tick_reads        = reads;
+            m_tick_writes       = writes;
+            m_tick_main_thread  = main_thread;
+        }
+
 		Context* m_context;
+
+    private:
+        uint32_t m_tick_reads   = SubsystemData_All;
+        uint32_t m_tick_writes  = SubsystemData_All;
+        bool m_tick_main_thread = true;
 	};
 
     template<typename T>
@@ -71,6 +71,9 @@ namespace Spartan
     {
         m_context = context;
 
+        // Doesn't tick, still ordered after the timer like the rest of its tick group
+        SetTickDependencies(SubsystemData_Time, SubsystemData_None);
+
         // Register pugixml
         const auto major = to_string(PUGIXML_VERSION / 1000);
         const auto minor = to_string(PUGIXML_VERSION).erase(0, 1).erase(1, 1);
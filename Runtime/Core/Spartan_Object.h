@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include <string>
+#include <atomic>
 #include "../Core/EngineDefs.h"
 //=============================
 
@@ -32,8 +33,8 @@ namespace Spartan
     class Context;
     //========================
 
-    // Globals
-	static uint32_t g_id = 0;
+    // Globals, objects are created from multiple threads (resource and world loading)
+	static std::atomic<uint32_t> g_id = 0;
 
 	class SPARTAN_CLASS Spartan_Object
 	{
@@ -43,13 +44,14 @@ namespace Spartan
             m_context   = context;
             m_id        = GenerateId();
         }
+        virtual ~Spartan_Object() = default;
 
         // Name
         const std::string& GetName()    const { return m_name; }
 
         // Id
 		const uint32_t GetId()          const { return m_id; }
-		void SetId(const uint32_t id)	      { m_id = id; }
+		virtual void SetId(const uint32_t id) { m_id = id; } // overridden by objects which are indexed by their id
         static uint32_t GenerateId()          { return ++g_id; }
 
         // CPU & GPU sizes
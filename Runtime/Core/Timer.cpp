@@ -36,6 +36,9 @@ namespace Spartan
 {
 	Timer::Timer(Context* context) : ISubsystem(context)
 	{
+        // Only touches its own times, the rest of its group reads them so it ticks (and frame limiting sleeps) before anything else
+        SetTickDependencies(SubsystemData_None, SubsystemData_Time, true);
+
         m_time_start        = chrono::high_resolution_clock::now();
 		m_time_frame_start  = chrono::high_resolution_clock::now();
 		m_time_frame_end    = chrono::high_resolution_clock::now();
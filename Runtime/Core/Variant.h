@@ -35,6 +35,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace Spartan
 {
 	class Entity;
+	struct WorldResolve;
 }
 //========================
 
@@ -52,6 +53,8 @@ namespace Spartan
 	std::weak_ptr<Spartan::Entity>,					\
 	std::vector<std::weak_ptr<Spartan::Entity>>,	\
 	std::vector<std::shared_ptr<Spartan::Entity>>,	\
+	const std::vector<std::shared_ptr<Spartan::Entity>>*,	\
+	const Spartan::WorldResolve*,					\
 	Spartan::Math::Vector2,							\
 	Spartan::Math::Vector3,							\
 	Spartan::Math::Vector4,							\
@@ -74,10 +77,14 @@ namespace Spartan
 		Variant(const Variant& var){ m_variant = var.GetVariantRaw(); }
 		// Copy constructor 2
 		template <class T, class = std::enable_if<!std::is_same<T, Variant>::value>>
-		Variant(T value) { m_variant = value; }
+		Variant(T value) { m_variant = std::move(value); }
+		// Move constructor
+		Variant(Variant&& var) noexcept { m_variant = std::move(var.m_variant); }
 
 		// Assignment operator 1
 		Variant& operator =(const Variant& rhs);
+		// Move assignment operator
+		Variant& operator =(Variant&& rhs) noexcept { m_variant = std::move(rhs.m_variant); return *this; }
 		// Assignment operator 2
 		template <class T, class = std::enable_if<!std::is_same<T, Variant>::value>>
 		Variant& operator =(T rhs) { return m_variant = rhs; }
@@ -0,0 +1,245 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ====================
+#include "Archive.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include "../Core/FileSystem.h"
+#include "../Logging/Log.h"
+#include "../Utilities/Hash.h"
+//===============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    static const uint32_t archive_magic     = 0x4B415053; // SPAK
+    static const uint32_t archive_version   = 1;
+    static const uint64_t archive_alignment = 16;
+
+    struct ArchiveHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entry_count;
+        uint32_t padding;
+        uint64_t names_offset;
+        uint64_t names_size;
+    };
+
+    struct ArchiveEntry
+    {
+        uint64_t hash;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t name_offset;
+        uint32_t name_size;
+    };
+
+    static uint64_t align(const uint64_t value)
+    {
+        return (value + archive_alignment - 1) & ~(archive_alignment - 1);
+    }
+
+    string Archive::NormalizePath(const string& path)
+    {
+        // The working directory, in the same form as the paths
+        static const string working_directory = []()
+        {
+            string directory = FileSystem::GetWorkingDirectory() + "/";
+            replace(directory.begin(), directory.end(), '\\', '/');
+            transform(directory.begin(), directory.end(), directory.begin(), [](const char c) { return static_cast<char>(tolower(c)); });
+            return directory;
+        }();
+
+        string normalized = path;
+        replace(normalized.begin(), normalized.end(), '\\', '/');
+        transform(normalized.begin(), normalized.end(), normalized.begin(), [](const char c) { return static_cast<char>(tolower(c)); });
+
+        if (normalized.compare(0, working_directory.size(), working_directory) == 0)
+        {
+            normalized.erase(0, working_directory.size());
+        }
+
+        while (normalized.compare(0, 2, "./") == 0)
+        {
+            normalized.erase(0, 2);
+        }
+
+        return normalized;
+    }
+
+	bool Archive::Pack(const vector<string>& file_paths, const string& archive_path)
+	{
+        struct PackedFile
+        {
+            string path;
+            string name;
+            ArchiveEntry entry;
+        };
+
+        // Gather the entries, sorted by hash, so that the table of contents can be binary searched
+        vector<PackedFile> files;
+        files.reserve(file_paths.size());
+        for (const string& file_path : file_paths)
+        {
+            error_code error;
+            const uintmax_t size = filesystem::file_size(file_path, error);
+            if (error)
+            {
+                LOG_WARNING("Skipping \"%s\", %s", file_path.c_str(), error.message().c_str());
+                continue;
+            }
+
+            PackedFile& file    = files.emplace_back();
+            file.path           = file_path;
+            file.name           = NormalizePath(file_path);
+            file.entry.hash     = Utility::Hash::fnv1a_64(file.name.data(), file.name.size());
+            file.entry.size     = static_cast<uint64_t>(size);
+        }
+        sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) { return a.entry.hash != b.entry.hash ? a.entry.hash < b.entry.hash : a.name < b.name; });
+        files.erase(unique(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) { return a.name == b.name; }), files.end());
+
+        // Lay out the archive: header, table of contents, names and then the file data
+        ArchiveHeader header    = {};
+        header.magic            = archive_magic;
+        header.version          = archive_version;
+        header.entry_count      = static_cast<uint32_t>(files.size());
+        header.names_offset     = sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * files.size();
+        for (PackedFile& file : files)
+        {
+            file.entry.name_offset  = static_cast<uint32_t>(header.names_size);
+            file.entry.name_size    = static_cast<uint32_t>(file.name.size());
+            header.names_size      += file.name.size();
+        }
+        uint64_t offset = align(header.names_offset + header.names_size);
+        for (PackedFile& file : files)
+        {
+            file.entry.offset   = offset;
+            offset              = align(offset + file.entry.size);
+        }
+
+        ofstream out(archive_path, ios::binary | ios::trunc);
+        if (!out.is_open())
+        {
+            LOG_ERROR("Failed to open \"%s\" for writing", archive_path.c_str());
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const PackedFile& file : files)
+        {
+            out.write(reinterpret_cast<const char*>(&file.entry), sizeof(file.entry));
+        }
+        for (const PackedFile& file : files)
+        {
+            out.write(file.name.data(), file.name.size());
+        }
+
+        vector<char> buffer;
+        for (const PackedFile& file : files)
+        {
+            out.seekp(file.entry.offset);
+
+            buffer.resize(file.entry.size);
+            ifstream in(file.path, ios::binary);
+            if (!in.read(buffer.data(), buffer.size()))
+            {
+                LOG_ERROR("Failed to read \"%s\"", file.path.c_str());
+                return false;
+            }
+
+            out.write(buffer.data(), buffer.size());
+        }
+
+        out.close();
+        if (out.fail())
+        {
+            LOG_ERROR("Failed to write \"%s\"", archive_path.c_str());
+            return false;
+        }
+
+        LOG_INFO("Packed %d files into \"%s\"", static_cast<int>(files.size()), archive_path.c_str());
+		return true;
+	}
+
+	bool Archive::Mount(const string& archive_path)
+	{
+        if (!m_file.Open(archive_path))
+            return false;
+
+        // Validate everything up front, lookups and reads trust the table of contents
+        const std::byte* data   = m_file.GetData();
+        const uint64_t size     = m_file.GetSize();
+        const ArchiveHeader* header = reinterpret_cast<const ArchiveHeader*>(data);
+        bool valid = size >= sizeof(ArchiveHeader) && header->magic == archive_magic && header->version == archive_version;
+        valid = valid && header->names_offset == sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * static_cast<uint64_t>(header->entry_count);
+        valid = valid && header->names_offset + header->names_size <= size;
+        const ArchiveEntry* entries = reinterpret_cast<const ArchiveEntry*>(data + sizeof(ArchiveHeader));
+        for (uint32_t i = 0; valid && i < header->entry_count; i++)
+        {
+            valid = entries[i].offset + entries[i].size <= size && static_cast<uint64_t>(entries[i].name_offset) + entries[i].name_size <= header->names_size;
+        }
+
+        if (!valid)
+        {
+            LOG_ERROR("\"%s\" is not a valid archive", archive_path.c_str());
+            m_file.Close();
+            return false;
+        }
+
+        m_entries       = entries;
+        m_entry_count   = header->entry_count;
+        m_names         = reinterpret_cast<const char*>(data + header->names_offset);
+        m_path          = archive_path;
+
+		return true;
+	}
+
+	bool Archive::Find(const string& file_path, const std::byte** data, uint64_t* size) const
+	{
+        if (!m_entries)
+            return false;
+
+        const string name   = NormalizePath(file_path);
+        const uint64_t hash = Utility::Hash::fnv1a_64(name.data(), name.size());
+
+        const ArchiveEntry* end = m_entries + m_entry_count;
+        const ArchiveEntry* it  = lower_bound(m_entries, end, hash, [](const ArchiveEntry& entry, const uint64_t value) { return entry.hash < value; });
+        for (; it != end && it->hash == hash; it++)
+        {
+            if (it->name_size != name.size() || memcmp(m_names + it->name_offset, name.data(), name.size()) != 0)
+                continue;
+
+            if (data) *data = m_file.GetData() + it->offset;
+            if (size) *size = it->size;
+            return true;
+        }
+
+        return false;
+	}
+}
@@ -0,0 +1,61 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES ==================
+#include <string>
+#include <vector>
+#include "MemoryMappedFile.h"
+//=============================
+
+namespace Spartan
+{
+    struct ArchiveEntry;
+
+    // Many engine files packed into one. The table of contents is sorted by path hash and is used straight from the
+    // memory mapped archive, so a lookup is a binary search and reading a file is a slice of the mapping.
+	class SPARTAN_CLASS Archive
+	{
+	public:
+		Archive() = default;
+		~Archive() = default;
+
+        // Build step, packs the files into an archive
+        static bool Pack(const std::vector<std::string>& file_paths, const std::string& archive_path);
+
+		bool Mount(const std::string& archive_path);
+        bool Find(const std::string& file_path, const std::byte** data, uint64_t* size) const;
+        const std::string& GetPath()    const { return m_path; }
+        uint32_t GetEntryCount()        const { return m_entry_count; }
+
+        // Entries are keyed by their lowercase path with forward slashes, relative to the working directory
+        static std::string NormalizePath(const std::string& path);
+
+	private:
+		MemoryMappedFile m_file;
+        const ArchiveEntry* m_entries   = nullptr;
+        uint32_t m_entry_count          = 0;
+        const char* m_names             = nullptr;
+        std::string m_path;
+	};
+}
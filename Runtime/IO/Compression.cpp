@@ -0,0 +1,206 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ==========
+#include "Compression.h"
+#include <cstring>
+#include <limits>
+//=====================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    // Matches are at least this long and can reach back this far
+    static const size_t match_length_min    = 4;
+    static const size_t match_offset_max    = 65535;
+
+    // The tail of a block is always emitted as literals, so matching never reads past the end
+    static const size_t match_end_margin    = 12;
+
+    static const uint32_t hash_bits         = 14;
+
+    static uint32_t read_u32(const byte* data)
+    {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static uint32_t hash_u32(const uint32_t value)
+    {
+        return (value * 2654435761u) >> (32 - hash_bits);
+    }
+
+    // Lengths which don't fit in a token nibble continue in extra bytes of 255, terminated by a smaller byte
+    static void write_length(vector<byte>& output, size_t length)
+    {
+        while (length >= 255)
+        {
+            output.emplace_back(static_cast<byte>(255));
+            length -= 255;
+        }
+        output.emplace_back(static_cast<byte>(length));
+    }
+
+    static bool read_length(const byte*& data, const byte* data_end, size_t& length)
+    {
+        uint8_t value = 255;
+        while (value == 255)
+        {
+            if (data >= data_end)
+                return false;
+
+            value   = static_cast<uint8_t>(*data++);
+            length  += value;
+        }
+
+        return true;
+    }
+
+    static void write_sequence(vector<byte>& output, const byte* literals, const size_t literal_count, const size_t offset, const size_t match_length)
+    {
+        // Token: literal count in the high nibble, match length (minus the minimum) in the low nibble
+        const size_t match_code = match_length != 0 ? match_length - match_length_min : 0;
+        output.emplace_back(static_cast<byte>((min<size_t>(literal_count, 15) << 4) | min<size_t>(match_code, 15)));
+
+        if (literal_count >= 15)
+        {
+            write_length(output, literal_count - 15);
+        }
+
+        output.insert(output.end(), literals, literals + literal_count);
+
+        // The last sequence of a block has no match
+        if (match_length == 0)
+            return;
+
+        output.emplace_back(static_cast<byte>(offset & 0xFF));
+        output.emplace_back(static_cast<byte>(offset >> 8));
+
+        if (match_code >= 15)
+        {
+            write_length(output, match_code - 15);
+        }
+    }
+
+	void Compression::Compress(const byte* data, const size_t size, vector<byte>& output)
+	{
+        vector<uint32_t> table(size_t(1) << hash_bits, numeric_limits<uint32_t>::max());
+
+        size_t position = 0;
+        size_t anchor   = 0;
+
+        if (size > match_end_margin)
+        {
+            const size_t position_last = size - match_end_margin;
+            while (position < position_last)
+            {
+                const uint32_t sequence = read_u32(data + position);
+                const uint32_t hash     = hash_u32(sequence);
+                const size_t candidate  = table[hash];
+                table[hash]             = static_cast<uint32_t>(position);
+
+                if (candidate == numeric_limits<uint32_t>::max() || position - candidate > match_offset_max || read_u32(data + candidate) != sequence)
+                {
+                    position++;
+                    continue;
+                }
+
+                // Extend the match, stopping short of the tail
+                size_t length = match_length_min;
+                while (position + length < position_last && data[candidate + length] == data[position + length])
+                {
+                    length++;
+                }
+
+                write_sequence(output, data + anchor, position - anchor, position - candidate, length);
+                position    += length;
+                anchor      = position;
+            }
+        }
+
+        write_sequence(output, data + anchor, size - anchor, 0, 0);
+	}
+
+	bool Compression::Decompress(const byte* data, const size_t size, byte* output, const size_t output_size)
+	{
+        const byte* data_end    = data + size;
+        byte* output_position   = output;
+        byte* output_end        = output + output_size;
+
+        while (data < data_end)
+        {
+            const uint8_t token = static_cast<uint8_t>(*data++);
+
+            // Literals
+            size_t literal_count = token >> 4;
+            if (literal_count == 15 && !read_length(data, data_end, literal_count))
+                return false;
+
+            if (literal_count > static_cast<size_t>(data_end - data) || literal_count > static_cast<size_t>(output_end - output_position))
+                return false;
+
+            memcpy(output_position, data, literal_count);
+            data            += literal_count;
+            output_position += literal_count;
+
+            // The last sequence ends with its literals
+            if (data == data_end)
+                break;
+
+            // Match
+            if (data_end - data < 2)
+                return false;
+
+            const size_t offset = static_cast<size_t>(data[0]) | (static_cast<size_t>(data[1]) << 8);
+            data += 2;
+
+            size_t match_length = token & 0x0F;
+            if (match_length == 15 && !read_length(data, data_end, match_length))
+                return false;
+            match_length += match_length_min;
+
+            if (offset == 0 || offset > static_cast<size_t>(output_position - output) || match_length > static_cast<size_t>(output_end - output_position))
+                return false;
+
+            // Matches can overlap the bytes they produce, in which case they have to be copied forward one at a time
+            const byte* match = output_position - offset;
+            if (offset >= match_length)
+            {
+                memcpy(output_position, match, match_length);
+                output_position += match_length;
+            }
+            else
+            {
+                for (size_t i = 0; i < match_length; i++)
+                {
+                    *output_position++ = *match++;
+                }
+            }
+        }
+
+        return output_position == output_end;
+	}
+}
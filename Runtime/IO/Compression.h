@@ -0,0 +1,43 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES ==================
+#include <vector>
+#include <cstddef>
+#include "../Core/EngineDefs.h"
+//=============================
+
+namespace Spartan
+{
+    // A fast LZ77 codec (LZ4 style sequences of literals and matches), it favours decoding speed over ratio
+	class SPARTAN_CLASS Compression
+	{
+	public:
+        // Appends the compressed data to output
+		static void Compress(const std::byte* data, size_t size, std::vector<std::byte>& output);
+
+        // Decodes exactly output_size bytes, fails on malformed or truncated input
+		static bool Decompress(const std::byte* data, size_t size, std::byte* output, size_t output_size);
+	};
+}
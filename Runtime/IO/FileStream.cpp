@@ -21,8 +21,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =================
 #include "FileStream.h"
+#include <cstring>
+#include <algorithm>
+#include "Archive.h"
+#include "MemoryMappedFile.h"
+#include "Compression.h"
+#include "../Core/FileSystem.h"
 #include "../Logging/Log.h"
 #include "../RHI/RHI_Vertex.h"
+#include "../Threading/Threading.h"
 //============================
 
 //= NAMESPACES =====
@@ -31,6 +38,35 @@ using namespace std;
 
 namespace Spartan
 {
+    static const size_t write_buffer_size = 1024 * 1024;
+
+    // Compressed files: a header, independently decodable blocks, the block index and a footer which locates the index
+    static const uint32_t compressed_magic      = 0x315A5053; // "SPZ1"
+    static const size_t compressed_block_size   = 256 * 1024;
+
+    struct CompressedHeader
+    {
+        uint32_t magic;
+        uint32_t block_size;
+    };
+
+    struct CompressedBlock
+    {
+        uint64_t offset;            // from the start of the file
+        uint32_t size_compressed;   // equal to size_raw when the block is stored as is
+        uint32_t size_raw;
+    };
+
+    struct CompressedFooter
+    {
+        uint64_t index_offset;
+        uint64_t size_raw;
+        uint32_t block_count;
+        uint32_t magic;
+    };
+
+    Threading* FileStream::m_threading = nullptr;
+
 	FileStream::FileStream(const string& path, uint32_t flags)
 	{
 		m_is_open	= false;
@@ -43,26 +79,109 @@ namespace Spartan
 
 		if (m_flags & FileStream_Write)
 		{
+            // Blocks are compressed independently and in sequence, appending to an existing file would break them
+            if ((m_flags & FileStream_Compressed) && (m_flags & FileStream_Append))
+            {
+                LOG_WARNING("Compression doesn't support appending, \"%s\" will be written uncompressed", path.c_str());
+                m_flags &= ~FileStream_Compressed;
+            }
+
 			out.open(path, ios_flags);
 			if (out.fail())
 			{
 				LOG_ERROR("Failed to open \"%s\" for writing", path.c_str());
 				return;
 			}
+
+            m_write_buffer.resize((m_flags & FileStream_Compressed) ? compressed_block_size : write_buffer_size);
+            m_write_buffer_offset = 0;
+
+            if (m_flags & FileStream_Compressed)
+            {
+                const CompressedHeader header = { compressed_magic, static_cast<uint32_t>(compressed_block_size) };
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                m_compressed_offset = sizeof(header);
+            }
 		}
 		else if (m_flags & FileStream_Read)
 		{
-			in.open(path, ios_flags);
-			if(in.fail())
-			{
-				LOG_ERROR("Failed to open \"%s\" for reading", path.c_str());
-				return;
-			}
+            // Files inside mounted archives are read straight from the mapped archive
+            m_archive = FileSystem::FindInArchives(path, &m_memory_data, &m_memory_size);
+
+            if (!m_archive && (m_flags & FileStream_Mmap))
+            {
+                m_mapping = make_unique<MemoryMappedFile>();
+                if (m_mapping->Open(path))
+                {
+                    m_memory_data   = m_mapping->GetData();
+                    m_memory_size   = m_mapping->GetSize();
+                }
+                else
+                {
+                    // Empty files can't be mapped, they can still be opened as a stream
+                    m_mapping = nullptr;
+                }
+            }
+
+            if (!m_memory_data)
+            {
+			    in.open(path, ios_flags);
+			    if(in.fail())
+			    {
+				    LOG_ERROR("Failed to open \"%s\" for reading", path.c_str());
+				    return;
+			    }
+
+                // Compressed files are decoded from memory
+                uint32_t magic = 0;
+                in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+                in.clear();
+                in.seekg(0);
+                if (magic == compressed_magic)
+                {
+                    in.close();
+
+                    m_mapping = make_unique<MemoryMappedFile>();
+                    if (!m_mapping->Open(path))
+                        return;
+
+                    m_memory_data   = m_mapping->GetData();
+                    m_memory_size   = m_mapping->GetSize();
+                }
+            }
+
+            if (m_memory_data && !Decompress())
+            {
+                LOG_ERROR("Failed to decompress \"%s\"", path.c_str());
+                return;
+            }
 		}
 
 		m_is_open = true;
 	}
 
+	FileStream::FileStream(const std::byte* data, const uint64_t size, const uint32_t flags /*= FileStream_Read*/)
+	{
+		m_flags			= FileStream_Read;
+        m_memory_data	= data;
+        m_memory_size	= size;
+		m_is_open		= data != nullptr;
+
+        // The bytes of a whole file (e.g. read ahead by the I/O thread) can be compressed
+        if (m_is_open && (flags & FileStream_Compressed) && !Decompress())
+        {
+            LOG_ERROR("Failed to decompress");
+            m_is_open = false;
+        }
+	}
+
+	FileStream::FileStream(vector<std::byte>* output)
+	{
+		m_flags			= FileStream_Write;
+        m_memory_output	= output;
+		m_is_open		= output != nullptr;
+	}
+
 	FileStream::~FileStream()
 	{
 		Close();
@@ -72,13 +191,43 @@ namespace Spartan
 	{
 		if (m_flags & FileStream_Write)
 		{
+            if (!out.is_open())
+                return;
+
+            FlushWriteBuffer();
+
+            // Finish compressed files with the block index and the footer that locates it
+            if (m_flags & FileStream_Compressed)
+            {
+                const CompressedFooter footer = { m_compressed_offset, m_compressed_size_raw, static_cast<uint32_t>(m_compressed_blocks.size() / sizeof(CompressedBlock)), compressed_magic };
+                out.write(reinterpret_cast<const char*>(m_compressed_blocks.data()), m_compressed_blocks.size());
+                out.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+                m_compressed_blocks.clear();
+                m_compressed_blocks.shrink_to_fit();
+            }
+
 			out.flush();
 			out.close();
+            m_write_buffer.clear();
+            m_write_buffer.shrink_to_fit();
 		}
 		else if (m_flags & FileStream_Read)
 		{
 			in.clear();
 			in.close();
+            m_archive       = nullptr;
+            m_mapping       = nullptr;
+            m_decompressed          = nullptr;
+            m_compressed_data       = nullptr;
+            m_compressed_blocks.clear();
+            m_compressed_blocks.shrink_to_fit();
+            m_compressed_offsets.clear();
+            m_compressed_offsets.shrink_to_fit();
+            m_compressed_decoded.clear();
+            m_compressed_decoded.shrink_to_fit();
+            m_memory_data   = nullptr;
+            m_memory_size   = 0;
+            m_memory_offset = 0;
 		}
 	}
 
@@ -87,7 +236,7 @@ namespace Spartan
 		const auto length = static_cast<uint32_t>(value.length());
 		Write(length);
 
-		out.write(const_cast<char*>(value.c_str()), length);
+		WriteBytes(value.c_str(), length);
 	}
 
 	void FileStream::Write(const vector<string>& value)
@@ -101,54 +250,294 @@ namespace Spartan
 		}
 	}
 
-	void FileStream::Write(const vector<RHI_Vertex_PosTexNorTan>& value)
-	{
-		const auto length = static_cast<uint32_t>(value.size());
-		Write(length);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(RHI_Vertex_PosTexNorTan) * length);
-	}
-
-	void FileStream::Write(const vector<uint32_t>& value)
-	{
-		const auto length = static_cast<uint32_t>(value.size());
-		Write(length);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(uint32_t) * length);
-	}
-
-	void FileStream::Write(const vector<unsigned char>& value)
-	{
-		const auto size = static_cast<uint32_t>(value.size());
-		Write(size);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(unsigned char) * size);
-	}
-
-	void FileStream::Write(const vector<std::byte>& value)
-	{
-		const auto size = static_cast<uint32_t>(value.size());
-		Write(size);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(std::byte) * size);
-	}
-
 	void FileStream::Skip(uint32_t n)
 	{
 		// Set the seek cursor to offset n from the current position
 		if (m_flags & FileStream_Write)
 		{
+            // Compressed and memory output can't seek, skipped bytes are zero either way
+            if ((m_flags & FileStream_Compressed) || m_memory_output)
+            {
+                const char zeros[256] = {};
+                for (uint32_t written = 0; written < n; written += sizeof(zeros))
+                {
+                    WriteBytes(zeros, min<size_t>(sizeof(zeros), n - written));
+                }
+                return;
+            }
+
+            FlushWriteBuffer();
 			out.seekp(n, ios::cur);
 		}
 		else if (m_flags & FileStream_Read)
 		{
-			in.ignore(n, ios::cur);
+            if (m_memory_data)
+            {
+                m_memory_offset = min(m_memory_offset + n, m_memory_size);
+            }
+            else
+            {
+			    in.ignore(n, ios::cur);
+            }
 		}
 	}
 
+    void FileStream::WriteBytes(const void* data, size_t size)
+    {
+        if (size == 0)
+            return;
+
+        if (m_memory_output)
+        {
+            const std::byte* bytes = static_cast<const std::byte*>(data);
+            m_memory_output->insert(m_memory_output->end(), bytes, bytes + size);
+            return;
+        }
+
+        // Make room, blocks which don't fit in the buffer go straight to the file (unless they have to be compressed)
+        if (m_write_buffer_offset + size > m_write_buffer.size())
+        {
+            FlushWriteBuffer();
+
+            if (size > m_write_buffer.size() && !(m_flags & FileStream_Compressed))
+            {
+                out.write(static_cast<const char*>(data), size);
+                return;
+            }
+        }
+
+        // Compressed output goes through the buffer, one block at a time
+        const char* source = static_cast<const char*>(data);
+        while (size != 0)
+        {
+            const size_t size_copy = min(size, m_write_buffer.size() - m_write_buffer_offset);
+            memcpy(m_write_buffer.data() + m_write_buffer_offset, source, size_copy);
+            m_write_buffer_offset   += size_copy;
+            source                  += size_copy;
+            size                    -= size_copy;
+
+            if (size != 0)
+            {
+                FlushWriteBuffer();
+            }
+        }
+    }
+
+    void FileStream::FlushWriteBuffer()
+    {
+        if (m_write_buffer_offset == 0)
+            return;
+
+        if (!(m_flags & FileStream_Compressed))
+        {
+            out.write(m_write_buffer.data(), m_write_buffer_offset);
+            m_write_buffer_offset = 0;
+            return;
+        }
+
+        // Compress the buffer into a block, blocks that don't shrink are stored as is
+        m_compressed_block.clear();
+        Compression::Compress(reinterpret_cast<const std::byte*>(m_write_buffer.data()), m_write_buffer_offset, m_compressed_block);
+        const bool stored = m_compressed_block.size() >= m_write_buffer_offset;
+
+        CompressedBlock block;
+        block.offset            = m_compressed_offset;
+        block.size_raw          = static_cast<uint32_t>(m_write_buffer_offset);
+        block.size_compressed   = stored ? block.size_raw : static_cast<uint32_t>(m_compressed_block.size());
+        out.write(stored ? m_write_buffer.data() : reinterpret_cast<const char*>(m_compressed_block.data()), block.size_compressed);
+
+        const auto block_bytes = reinterpret_cast<const std::byte*>(&block);
+        m_compressed_blocks.insert(m_compressed_blocks.end(), block_bytes, block_bytes + sizeof(block));
+        m_compressed_offset     += block.size_compressed;
+        m_compressed_size_raw   += block.size_raw;
+        m_write_buffer_offset   = 0;
+    }
+
+    bool FileStream::Decompress()
+    {
+        const std::byte* data   = m_memory_data;
+        const uint64_t size     = m_memory_size;
+
+        // Files written without compression are read as they are
+        if (size < sizeof(CompressedHeader) + sizeof(CompressedFooter))
+            return true;
+
+        CompressedHeader header;
+        memcpy(&header, data, sizeof(header));
+        if (header.magic != compressed_magic)
+            return true;
+
+        CompressedFooter footer;
+        memcpy(&footer, data + size - sizeof(footer), sizeof(footer));
+        const uint64_t index_size = static_cast<uint64_t>(footer.block_count) * sizeof(CompressedBlock);
+        if (footer.magic != compressed_magic || footer.index_offset > size - sizeof(footer) || index_size != size - sizeof(footer) - footer.index_offset)
+            return false;
+
+        // Locate each block in the decompressed output
+        m_compressed_blocks.resize(index_size);
+        m_compressed_offsets.resize(footer.block_count + 1);
+        memcpy(m_compressed_blocks.data(), data + footer.index_offset, index_size);
+        uint64_t offset = 0;
+        for (uint32_t i = 0; i < footer.block_count; i++)
+        {
+            CompressedBlock block;
+            memcpy(&block, m_compressed_blocks.data() + i * sizeof(CompressedBlock), sizeof(block));
+            if (block.offset > footer.index_offset || block.size_compressed > footer.index_offset - block.offset)
+                return false;
+
+            m_compressed_offsets[i] = offset;
+            offset                  += block.size_raw;
+        }
+        m_compressed_offsets[footer.block_count] = offset;
+
+        if (offset != footer.size_raw)
+            return false;
+
+        // Nothing is decoded yet, reads decode the blocks they touch. The memory is left uninitialized, so only
+        // the pages of the blocks which are read are ever committed (an empty file still gets valid memory).
+        m_compressed_data = data;
+        m_compressed_decoded.assign(footer.block_count, 0);
+        m_decompressed.reset(new std::byte[max<uint64_t>(footer.size_raw, 1)]);
+
+        // The rest of the stream reads from the decompressed data, the source (mapping or archive) stays around for the blocks
+        m_memory_data   = m_decompressed.get();
+        m_memory_size   = footer.size_raw;
+        m_memory_offset = 0;
+
+        return true;
+    }
+
+    bool FileStream::DecompressRange(const uint64_t offset, const uint64_t size)
+    {
+        if (!m_compressed_data || size == 0)
+            return true;
+
+        // The blocks which overlap [offset, offset + size)
+        const uint32_t block_count  = static_cast<uint32_t>(m_compressed_decoded.size());
+        const auto offsets_begin    = m_compressed_offsets.begin();
+        const auto offsets_end      = m_compressed_offsets.begin() + block_count;
+        const uint32_t block_first  = static_cast<uint32_t>(upper_bound(offsets_begin, offsets_end, offset) - offsets_begin) - 1;
+        const uint32_t block_end    = static_cast<uint32_t>(lower_bound(offsets_begin, offsets_end, offset + size) - offsets_begin);
+
+        atomic<bool> failed = false;
+        const auto decompress_blocks = [this, &failed, block_first](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = block_first + start; i < block_first + end; i++)
+            {
+                if (m_compressed_decoded[i])
+                    continue;
+
+                CompressedBlock block;
+                memcpy(&block, m_compressed_blocks.data() + i * sizeof(CompressedBlock), sizeof(block));
+                std::byte* output = m_decompressed.get() + m_compressed_offsets[i];
+
+                if (block.size_compressed == block.size_raw)
+                {
+                    memcpy(output, m_compressed_data + block.offset, block.size_raw);
+                }
+                else if (!Compression::Decompress(m_compressed_data + block.offset, block.size_compressed, output, block.size_raw))
+                {
+                    failed = true;
+                    continue;
+                }
+
+                m_compressed_decoded[i] = 1;
+            }
+        };
+
+        // The blocks are independent, so large reads decode them in parallel
+        static const uint32_t parallel_threshold = 4;
+        const uint32_t count = block_end - block_first;
+        if (m_threading && count >= parallel_threshold)
+        {
+            m_threading->AddTaskLoop(decompress_blocks, count, 1);
+        }
+        else
+        {
+            decompress_blocks(0, count);
+        }
+
+        if (failed)
+        {
+            LOG_ERROR("Failed to decompress");
+            return false;
+        }
+
+        return true;
+    }
+
+    void FileStream::ReadBytes(void* data, const size_t size)
+    {
+        if (!m_memory_data)
+        {
+            in.read(static_cast<char*>(data), size);
+            return;
+        }
+
+        // Reading past the end (or a block which fails to decompress) zeroes the rest
+        size_t size_available = static_cast<size_t>(min<uint64_t>(size, m_memory_size - m_memory_offset));
+        if (!DecompressRange(m_memory_offset, size_available))
+        {
+            size_available  = 0;
+            m_memory_offset = m_memory_size;
+        }
+
+        memcpy(data, m_memory_data + m_memory_offset, size_available);
+        memset(static_cast<char*>(data) + size_available, 0, size - size_available);
+        m_memory_offset += size_available;
+    }
+
+    const void* FileStream::ReadViewBytes(const uint64_t size)
+    {
+        if (!m_memory_data)
+        {
+            LOG_ERROR("Views require a memory backed stream");
+            return nullptr;
+        }
+
+        if (size > m_memory_size - m_memory_offset)
+        {
+            LOG_ERROR("Attempted to read past the end of the file");
+            m_memory_offset = m_memory_size;
+            return nullptr;
+        }
+
+        if (!DecompressRange(m_memory_offset, size))
+        {
+            m_memory_offset = m_memory_size;
+            return nullptr;
+        }
+
+        const std::byte* view = m_memory_data + m_memory_offset;
+        m_memory_offset += size;
+        return view;
+    }
+
+    uint64_t FileStream::GetPosition()
+    {
+        return m_memory_data ? m_memory_offset : static_cast<uint64_t>(in.tellg());
+    }
+
+    void FileStream::Seek(const uint64_t position)
+    {
+        if (m_memory_data)
+        {
+            m_memory_offset = min(position, m_memory_size);
+        }
+        else
+        {
+            in.clear();
+            in.seekg(position);
+        }
+    }
+
 	void FileStream::Read(string* value)
 	{
 		uint32_t length = 0;
 		Read(&length);
 
 		value->resize(length);
-		in.read(const_cast<char*>(value->c_str()), length);
+		ReadBytes(value->data(), length);
 	}
 
 	void FileStream::Read(vector<string>* vec)
@@ -162,75 +551,11 @@ namespace Spartan
 		uint32_t size = 0;
 		Read(&size);
 
-		string str;
-		for (uint32_t i = 0; i < size; i++)
+		vec->resize(size);
+		for (string& str : *vec)
 		{
 			Read(&str);
-			vec->emplace_back(str);
 		}
 	}
 
-	void FileStream::Read(vector<RHI_Vertex_PosTexNorTan>* vec)
-	{
-		if (!vec)
-			return;
-
-		vec->clear();
-		vec->shrink_to_fit();
-
-        const auto length = ReadAs<uint32_t>();
-
-		vec->reserve(length);
-		vec->resize(length);
-
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(RHI_Vertex_PosTexNorTan) * length);
-	}
-
-	void FileStream::Read(vector<uint32_t>* vec)
-	{
-		if (!vec)
-			return;
-
-		vec->clear();
-		vec->shrink_to_fit();
-
-        const auto length = ReadAs<uint32_t>();
-
-		vec->reserve(length);
-		vec->resize(length);
-
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(uint32_t) * length);
-	}
-
-	void FileStream::Read(vector<unsigned char>* vec)
-	{
-		if (!vec)
-			return;
-
-		vec->clear();
-		vec->shrink_to_fit();
-
-        const auto length = ReadAs<uint32_t>();
-
-		vec->reserve(length);
-		vec->resize(length);
-
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(unsigned char) * length);
-	}
-
-	void FileStream::Read(vector<std::byte>* vec)
-	{
-		if (!vec)
-			return;
-
-		vec->clear();
-		vec->shrink_to_fit();
-
-		const auto length = ReadAs<uint32_t>();
-
-		vec->reserve(length);
-		vec->resize(length);
-
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(std::byte) * length);
-	}
 }
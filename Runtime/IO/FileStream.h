@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===================
 #include <vector>
 #include <fstream>
+#include <memory>
 #include "../Math/Vector2.h"
 #include "../Math/Vector3.h"
 #include "../Math/Vector4.h"
@@ -34,127 +35,163 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace Spartan
 {
 	class Entity;
+    class Archive;
+    class MemoryMappedFile;
+    class Threading;
+
+	// Types which are written and read as raw bytes (the math types aren't trivially copyable only because of their copy-constructors)
+	template <class T>
+	constexpr bool is_stream_pod_v =
+		(std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value)	||
+		std::is_same<T, Math::Vector2>::value									||
+		std::is_same<T, Math::Vector3>::value									||
+		std::is_same<T, Math::Vector4>::value									||
+		std::is_same<T, Math::Quaternion>::value								||
+		std::is_same<T, Math::BoundingBox>::value;
 
 	enum FileStream_Mode : uint32_t
 	{
-		FileStream_Read		= 1 << 0,
-		FileStream_Write	= 1 << 1,
-		FileStream_Append	= 1 << 2,
+		FileStream_Read			= 1 << 0,
+		FileStream_Write		= 1 << 1,
+		FileStream_Append		= 1 << 2,
+		FileStream_Mmap			= 1 << 3, // reading maps the file, which allows zero-copy reads through ReadView()
+		FileStream_Compressed	= 1 << 4, // writing compresses the file in blocks, reading detects such files and decodes the blocks as they are read
 	};
 
 	class SPARTAN_CLASS FileStream
 	{
 	public:
 		FileStream(const std::string& path, uint32_t flags);
+		FileStream(const std::byte* data, uint64_t size, uint32_t flags = FileStream_Read); // reads from memory, which has to outlive the stream
+		FileStream(std::vector<std::byte>* output);         // writes append to output
 		~FileStream();
 
-		auto IsOpen() const { return m_is_open; }
+		auto IsOpen() const         { return m_is_open; }
+		bool IsMemoryBacked() const { return m_memory_data != nullptr; }
 		void Close();
 
-		//= WRITING ==================================================
-		template <class T, class = typename std::enable_if<
-			std::is_same<T, bool>::value				||
-			std::is_same<T, unsigned char>::value		||		
-			std::is_same<T, int>::value					||
-			std::is_same<T, long>::value				||
-			std::is_same<T, long long>::value			||
-			std::is_same<T, uint8_t>::value			    ||
-            std::is_same<T, uint16_t>::value			||
-            std::is_same<T, uint32_t>::value			||
-            std::is_same<T, uint64_t>::value			||
-			std::is_same<T, unsigned long>::value		||
-			std::is_same<T, unsigned long long>::value	||
-			std::is_same<T, float>::value				||
-			std::is_same<T, double>::value				||
-			std::is_same<T, long double>::value			||
-			std::is_same<T, std::byte>::value			||
-			std::is_same<T, Math::Vector2>::value		||
-			std::is_same<T, Math::Vector3>::value		||
-			std::is_same<T, Math::Vector4>::value		||
-			std::is_same<T, Math::Quaternion>::value	||
-			std::is_same<T, Math::BoundingBox>::value
-		>::type>
+        // Large reads of compressed files decode their blocks in parallel on this, when set
+        static void SetThreading(Threading* threading) { m_threading = threading; }
+
+		//= WRITING ================================================================
+		template <class T, class = typename std::enable_if<is_stream_pod_v<T>>::type>
 		void Write(T value)
 		{
-			out.write(reinterpret_cast<char*>(&value), sizeof(value));
+			WriteBytes(&value, sizeof(T));
+		}
+
+		// Writes count elements as one block, without a size prefix
+		template <class T, class = typename std::enable_if<is_stream_pod_v<T>>::type>
+		void Write(const T* data, const size_t count)
+		{
+			WriteBytes(data, sizeof(T) * count);
+		}
+
+		// Writes the element count followed by all elements as one block
+		template <class T, class = typename std::enable_if<is_stream_pod_v<T>>::type>
+		void Write(const std::vector<T>& value)
+		{
+			Write(static_cast<uint32_t>(value.size()));
+			WriteBytes(value.data(), sizeof(T) * value.size());
 		}
 
 		void Write(const std::string& value);
 		void Write(const std::vector<std::string>& value);
-		void Write(const std::vector<RHI_Vertex_PosTexNorTan>& value);
-		void Write(const std::vector<uint32_t>& value);
-		void Write(const std::vector<unsigned char>& value);
-		void Write(const std::vector<std::byte>& value);
 		void Skip(uint32_t n);
-		//===========================================================
+		//=========================================================================
 		
 		//= READING ===========================================
-		template <class T, class = typename std::enable_if
-		<
-			std::is_same<T, bool>::value				||
-			std::is_same<T, unsigned char>::value		||
-			std::is_same<T, int>::value					||
-			std::is_same<T, long>::value				||
-			std::is_same<T, long long>::value			||
-            std::is_same<T, uint8_t>::value			    ||
-            std::is_same<T, uint16_t>::value			||
-            std::is_same<T, uint32_t>::value			||
-			std::is_same<T, uint64_t>::value			||
-			std::is_same<T, unsigned long>::value		||
-			std::is_same<T, unsigned long long>::value	||
-			std::is_same<T, float>::value				||
-			std::is_same<T, double>::value				||
-			std::is_same<T, long double>::value			||
-			std::is_same<T, std::byte>::value			||
-			std::is_same<T, Math::Vector2>::value		||
-			std::is_same<T, Math::Vector3>::value		||
-			std::is_same<T, Math::Vector4>::value		||
-			std::is_same<T, Math::Quaternion>::value	||
-			std::is_same<T, Math::BoundingBox>::value
-		>::type>
+		template <class T, class = typename std::enable_if<is_stream_pod_v<T>>::type>
 		void Read(T* value)
 		{
-			in.read(reinterpret_cast<char*>(value), sizeof(T));
+			ReadBytes(value, sizeof(T));
+		}
+
+		// Reads count elements written by Write(const T*, size_t)
+		template <class T, class = typename std::enable_if<is_stream_pod_v<T>>::type>
+		void Read(T* data, const size_t count)
+		{
+			ReadBytes(data, sizeof(T) * count);
 		}
+
+		template <class T, class = typename std::enable_if<is_stream_pod_v<T>>::type>
+		void Read(std::vector<T>* vec)
+		{
+			if (!vec)
+				return;
+
+			vec->clear();
+			vec->shrink_to_fit();
+			vec->resize(ReadAs<uint32_t>());
+
+			ReadBytes(vec->data(), sizeof(T) * vec->size());
+		}
+
 		void Read(std::string* value);
 		void Read(std::vector<std::string>* vec);
-		void Read(std::vector<RHI_Vertex_PosTexNorTan>* vec);
-		void Read(std::vector<uint32_t>* vec);
-		void Read(std::vector<unsigned char>* vec);
-		void Read(std::vector<std::byte>* vec);
+
+		// Position of the read cursor, from the start of the (decompressed) data
+		uint64_t GetPosition();
+		void Seek(uint64_t position);
 
 		// Reading with explicit type definition
-		template <class T, class = typename std::enable_if
-		<
-			std::is_same<T, bool>::value				||
-			std::is_same<T, unsigned char>::value		||		
-			std::is_same<T, int>::value					||
-			std::is_same<T, long>::value				||
-			std::is_same<T, long long>::value			||
-			std::is_same<T, uint8_t>::value			    ||
-            std::is_same<T, uint16_t>::value			||
-            std::is_same<T, uint32_t>::value			||
-            std::is_same<T, uint64_t>::value			||
-			std::is_same<T, unsigned long>::value		||
-			std::is_same<T, unsigned long long>::value	||
-			std::is_same<T, float>::value				||
-			std::is_same<T, double>::value				||
-			std::is_same<T, long double>::value			||
-			std::is_same<T, std::byte>::value			||
-			std::is_same<T, std::string>::value
-		>::type> 
+		template <class T, class = typename std::enable_if<is_stream_pod_v<T> || std::is_same<T, std::string>::value>::type> 
 		T ReadAs()
 		{
 			T value;
 			Read(&value);
 			return value;
 		}
+
+		// Zero-copy read of a vector written by Write(), the returned pointer points into the file's memory and is valid
+		// until the stream is closed. Only memory backed streams support this (FileStream_Mmap or files inside an archive).
+		// The data can be at any offset, so only byte-aligned types can be viewed, the rest (vertices, indices, etc.) are
+		// read with Read(std::vector<T>*), which copies them into aligned memory.
+		template <class T>
+		const T* ReadView(uint32_t* count)
+		{
+			static_assert(alignof(T) == 1 && is_stream_pod_v<T>, "Views can be at any offset, read types with a larger alignment through Read()");
+
+			*count = ReadAs<uint32_t>();
+			return static_cast<const T*>(ReadViewBytes(static_cast<uint64_t>(*count) * sizeof(T)));
+		}
 		//=====================================================
 
 	private:
+        void WriteBytes(const void* data, size_t size);
+        void FlushWriteBuffer();
+        bool Decompress();
+        bool DecompressRange(uint64_t offset, uint64_t size);
+        void ReadBytes(void* data, size_t size);
+        const void* ReadViewBytes(uint64_t size);
+
 		std::ofstream out;
 		std::ifstream in;
+
+        // Writes are gathered here and reach the file in large blocks
+        std::vector<char> m_write_buffer;
+        size_t m_write_buffer_offset = 0;
+        std::vector<std::byte>* m_memory_output = nullptr;
+
+        // Compressed writing and reading
+        std::vector<std::byte> m_compressed_block;
+        std::vector<std::byte> m_compressed_blocks; // block index
+        std::vector<uint64_t> m_compressed_offsets; // where each block starts in the decompressed data, followed by its size
+        std::vector<uint8_t> m_compressed_decoded;  // which blocks have been decoded so far
+        const std::byte* m_compressed_data = nullptr;
+        uint64_t m_compressed_offset    = 0;
+        uint64_t m_compressed_size_raw  = 0;
 		uint32_t m_flags;
 		bool m_is_open;
+
+        // Reading from memory, a mounted archive (which the stream keeps alive) or a memory mapped file
+        std::shared_ptr<Archive> m_archive;
+        std::unique_ptr<MemoryMappedFile> m_mapping;
+        const std::byte* m_memory_data  = nullptr;
+        uint64_t m_memory_size          = 0;
+        uint64_t m_memory_offset        = 0;
+        std::unique_ptr<std::byte[]> m_decompressed;
+
+        static Threading* m_threading;
 	};
 }
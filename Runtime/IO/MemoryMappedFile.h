@@ -0,0 +1,56 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES ==================
+#include <string>
+#include <cstddef>
+#include "../Core/EngineDefs.h"
+//=============================
+
+namespace Spartan
+{
+    // A read-only view of a whole file, the operating system pages it in as it's touched
+	class SPARTAN_CLASS MemoryMappedFile
+	{
+	public:
+		MemoryMappedFile() = default;
+		~MemoryMappedFile();
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+		bool Open(const std::string& path);
+		void Close();
+
+        bool IsOpen()               const { return m_data != nullptr; }
+        const std::byte* GetData()  const { return m_data; }
+        uint64_t GetSize()          const { return m_size; }
+
+	private:
+        const std::byte* m_data = nullptr;
+        uint64_t m_size         = 0;
+        void* m_file            = nullptr;
+        void* m_mapping         = nullptr;
+	};
+}
@@ -40,6 +40,9 @@ namespace Spartan
 
 	Input::Input(Context* context) : ISubsystem(context)
 	{
+        // Polls devices, has to tick on the main thread
+        SetTickDependencies(SubsystemData_None, SubsystemData_Input, true);
+
         const WindowData& window_data   = context->m_engine->GetWindowData();
 		const auto window_handle	    = static_cast<HWND>(window_data.handle);
 
@@ -51,6 +51,9 @@ namespace Spartan
 
 	Physics::Physics(Context* context) : ISubsystem(context)
 	{
+        // Writes the transforms of rigid bodies and the renderer's debug lines, can tick on any thread once the timer has ticked
+        SetTickDependencies(SubsystemData_Time | SubsystemData_Rendering | SubsystemData_Profiling, SubsystemData_Physics | SubsystemData_World | SubsystemData_Rendering);
+
         m_broadphase        = new btDbvtBroadphase();
         m_constraint_solver = new btSequentialImpulseConstraintSolver();
 
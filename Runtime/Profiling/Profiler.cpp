@@ -25,7 +25,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Rendering/Renderer.h"
 #include "../RHI/RHI_CommandList.h"
 #include "../Resource/ResourceCache.h"
+#include "../Resource/Import/ImportCache.h"
 #include "../RHI/RHI_Implementation.h"
+#include "../Threading/Threading.h"
 //====================================
 
 //= NAMESPACES =====
@@ -36,6 +38,9 @@ namespace Spartan
 {
 	Profiler::Profiler(Context* context) : ISubsystem(context)
 	{
+        // Ends the frame's time blocks, so it waits for the subsystems which record them. Queries the rhi device on the main thread.
+        SetTickDependencies(SubsystemData_Time | SubsystemData_Rendering, SubsystemData_Profiling, true);
+
         m_time_blocks_read.reserve(m_time_block_capacity);
         m_time_blocks_read.resize(m_time_block_capacity);
 		m_time_blocks_write.reserve(m_time_block_capacity);
@@ -125,6 +130,9 @@ namespace Spartan
             if (m_renderer->GetOptions() & Render_Debug_PerformanceMetrics)
             {
                 UpdateRhiMetricsString();
+                UpdateTickMetricsString();
+                UpdateTaskMetricsString();
+                UpdateImportMetricsString();
             }
         }
 
@@ -135,6 +143,8 @@ namespace Spartan
     {
         // Clear time blocks
         {
+            lock_guard<mutex> lock(m_mutex_time_blocks);
+
             for (uint32_t i = 0; i < m_time_block_count; i++)
             {
                 TimeBlock& time_block = m_time_blocks_write[i];
@@ -206,7 +216,9 @@ namespace Spartan
 		if (!can_profile_cpu && !can_profile_gpu)
 			return;
 
-        // Last incomplete block of the same type, is the parent
+        lock_guard<mutex> lock(m_mutex_time_blocks);
+
+        // Last incomplete block of the same type (and thread), is the parent
         TimeBlock* time_block_parent = GetLastIncompleteTimeBlock(type);
 
 		if (TimeBlock* time_block = GetNewTimeBlock())
@@ -221,6 +233,8 @@ namespace Spartan
         if (m_increase_capacity)
             return;
 
+        lock_guard<mutex> lock(m_mutex_time_blocks);
+
 		if (TimeBlock* time_block = GetLastIncompleteTimeBlock())
 		{
 			time_block->End();
@@ -242,10 +256,15 @@ namespace Spartan
 
 	TimeBlock* Profiler::GetLastIncompleteTimeBlock(TimeBlock_Type type /*= TimeBlock_Undefined*/)
 	{
+        const thread::id thread_id = this_thread::get_id();
+
 		for (int i = m_time_block_count - 1; i >= 0; i--)
 		{
 			TimeBlock& time_block = m_time_blocks_write[i];
 
+            if (time_block.GetThreadId() != thread_id)
+                continue;
+
             if (type == time_block.GetType() || type == TimeBlock_Undefined)
             {
                 if (!time_block.IsComplete())
@@ -338,4 +357,57 @@ namespace Spartan
 
 		m_metrics = string(buffer);
 	}
+
+    void Profiler::UpdateTickMetricsString()
+    {
+        // Which subsystems limit the frame time
+        for (const Tick_Group tick_group : { Tick_Variable, Tick_Smoothed })
+        {
+            const TickReport& report = m_context->GetTickReport(tick_group);
+
+            string path;
+            for (const SubsystemTiming& timing : report.subsystems)
+            {
+                if (!timing.on_critical_path)
+                    continue;
+
+                path += (path.empty() ? "" : " > ") + timing.name;
+            }
+
+            char buffer[256];
+            sprintf_s(buffer, "\nCritical path:\t\t\t\t\t%.2f/%.2f ms (%s)", report.critical_path_ms, report.duration_ms, path.c_str());
+            m_metrics += buffer;
+        }
+    }
+
+    void Profiler::UpdateTaskMetricsString()
+    {
+        Threading* threading = m_context->GetSubsystem<Threading>();
+        if (!threading)
+            return;
+
+        // Queue depth and how long tasks waited in the queue since the last update
+        const char* names[] = { "critical", "normal", "background" };
+        for (const Task_Priority priority : { Task_Critical, Task_Normal, Task_Background })
+        {
+            const TaskStats stats = threading->GetTaskStats(priority);
+
+            char buffer[256];
+            sprintf_s(buffer, "\nTasks (%s):\t\t\t\t%d queued, %d executed, %.2f/%.2f ms latency (avg/max)", names[priority], stats.queued, stats.executed, stats.latency_avg_ms, stats.latency_max_ms);
+            m_metrics += buffer;
+        }
+    }
+
+    void Profiler::UpdateImportMetricsString()
+    {
+        ResourceCache* resource_cache = m_context->GetSubsystem<ResourceCache>();
+        if (!resource_cache || !resource_cache->GetImportCache())
+            return;
+
+        // Imports which were served from the import cache, instead of being imported again
+        const ImportCache* import_cache = resource_cache->GetImportCache();
+        char buffer[256];
+        sprintf_s(buffer, "\nImport cache:\t\t\t\t\t%d hits, %d misses", import_cache->GetHitCount(), import_cache->GetMissCount());
+        m_metrics += buffer;
+    }
 }
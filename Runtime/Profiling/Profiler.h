@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ==================
 #include <string>
 #include <vector>
+#include <mutex>
 #include "TimeBlock.h"
 #include "../Core/EngineDefs.h"
 #include "../Core/ISubsystem.h"
@@ -118,6 +119,9 @@ namespace Spartan
 		TimeBlock* GetLastIncompleteTimeBlock(TimeBlock_Type type = TimeBlock_Undefined);
 		void ComputeFps(float delta_time);
 		void UpdateRhiMetricsString();
+        void UpdateTickMetricsString();
+        void UpdateTaskMetricsString();
+        void UpdateImportMetricsString();
 
 		// Profiling options
 		bool m_profile_cpu_enabled			= true; // cheap
@@ -130,6 +134,7 @@ namespace Spartan
 		uint32_t m_time_block_count		= 0;
 		std::vector<TimeBlock> m_time_blocks_write;
         std::vector<TimeBlock> m_time_blocks_read;
+        std::mutex m_mutex_time_blocks; // subsystems can tick in parallel
 
 		// FPS
         float m_delta_time      = 0.0f;
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <chrono>
 #include <memory>
+#include <thread>
 #include "..\RHI\RHI_Definition.h"
 //================================
 
@@ -55,6 +56,7 @@ namespace Spartan
         uint32_t GetTreeDepthMax()      const { return m_max_tree_depth; }
         float GetDuration()             const { return m_duration; }
         bool IsComplete()               const { return m_is_complete; }
+        std::thread::id GetThreadId()   const { return m_thread_id; }
 
 	private:	
 		static uint32_t FindTreeDepth(const TimeBlock* time_block, uint32_t depth = 0);
@@ -67,6 +69,7 @@ namespace Spartan
 		uint32_t m_tree_depth	    = 0;
         bool m_is_complete          = false;
         RHI_Device* m_rhi_device    = nullptr;
+        std::thread::id m_thread_id;
 
 		// CPU timing
 		std::chrono::steady_clock::time_point m_start;
@@ -45,7 +45,7 @@ namespace Spartan
 		safe_release(*reinterpret_cast<ID3D11VertexShader**>(&m_resource));
 	}
 
-	void* RHI_Shader::_Compile(const string& shader)
+	void* RHI_Shader::_Compile(const string& shader, const string& source)
 	{
 		if (!m_rhi_device)
 		{
@@ -85,7 +85,24 @@ namespace Spartan
 		ID3DBlob* blob_error	= nullptr;
 		ID3DBlob* shader_blob	= nullptr;
 		HRESULT result;
-		if (FileSystem::IsFile(shader)) // From file ?
+		if (FileSystem::IsFile(shader) && !source.empty()) // From a file which was read ahead ?
+		{
+            result = D3DCompile
+            (
+                source.c_str(),
+                static_cast<SIZE_T>(source.size()),
+                shader.c_str(), // includes are resolved relative to it
+                defines.data(),
+                D3D_COMPILE_STANDARD_FILE_INCLUDE,
+                GetEntryPoint(),
+                GetTargetProfile(),
+                compile_flags,
+                0,
+                &shader_blob,
+                &blob_error
+            );
+		}
+		else if (FileSystem::IsFile(shader)) // From file ?
 		{
             const auto file_path = FileSystem::StringToWstring(shader);
 			result = D3DCompileFromFile
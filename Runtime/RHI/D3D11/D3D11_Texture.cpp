@@ -102,15 +102,17 @@ namespace Spartan
 		const uint32_t array_size,
 		const DXGI_FORMAT format,
 		const UINT bind_flags,
-		vector<vector<std::byte>>& data,
+		const RHI_Texture* source,
 		const shared_ptr<RHI_Device>& rhi_device
 	)
 	{
+        const uint32_t mip_count = source->GetMipDataCount();
+
         // Describe
 		D3D11_TEXTURE2D_DESC texture_desc	= {};
 		texture_desc.Width					= static_cast<UINT>(width);
 		texture_desc.Height					= static_cast<UINT>(height);
-		texture_desc.MipLevels				= data.empty() ? 1 : static_cast<UINT>(data.size());
+		texture_desc.MipLevels				= mip_count == 0 ? 1 : static_cast<UINT>(mip_count);
 		texture_desc.ArraySize				= static_cast<UINT>(array_size);
 		texture_desc.Format					= format;
 		texture_desc.SampleDesc.Count		= 1;
@@ -122,16 +124,17 @@ namespace Spartan
 
 		// Fill subresource data
 		vector<D3D11_SUBRESOURCE_DATA> vec_subresource_data;
-		for (uint32_t mip_level = 0; mip_level < static_cast<uint32_t>(data.size()); mip_level++)
+		for (uint32_t mip_level = 0; mip_level < mip_count; mip_level++)
 		{
-			if (data[mip_level].empty())
+            const std::byte* mip_data = source->GetMipData(mip_level);
+			if (!mip_data)
 			{
 				LOG_ERROR("Mipmap %d has invalid data.", mip_level);
 				return false;
 			}
 
 			auto& subresource_data				= vec_subresource_data.emplace_back(D3D11_SUBRESOURCE_DATA{});
-			subresource_data.pSysMem			= data[mip_level].data();					                // Data pointer		
+			subresource_data.pSysMem			= mip_data;					                                // Data pointer		
 			subresource_data.SysMemPitch		= (width >> mip_level) * channels * (bits_per_channel / 8);	// Line width in bytes
 			subresource_data.SysMemSlicePitch	= 0;								                        // This is only used for 3D textures
 		}
@@ -198,7 +201,7 @@ namespace Spartan
 		return true;
 	}
 
-	inline bool CreateShaderResourceView2d(void* texture, void*& view, DXGI_FORMAT format, uint32_t array_size, vector<vector<std::byte>>& data, const shared_ptr<RHI_Device>& rhi_device)
+	inline bool CreateShaderResourceView2d(void* texture, void*& view, DXGI_FORMAT format, uint32_t array_size, const RHI_Texture* source, const shared_ptr<RHI_Device>& rhi_device)
 	{
 		// Describe
 		D3D11_SHADER_RESOURCE_VIEW_DESC shader_resource_view_desc	= {};
@@ -206,7 +209,7 @@ namespace Spartan
 		shader_resource_view_desc.ViewDimension						= (array_size == 1) ? D3D11_SRV_DIMENSION_TEXTURE2D : D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
 		shader_resource_view_desc.Texture2DArray.FirstArraySlice	= 0;
 		shader_resource_view_desc.Texture2DArray.MostDetailedMip	= 0;
-		shader_resource_view_desc.Texture2DArray.MipLevels			= data.empty() ? 1 : static_cast<UINT>(data.size());
+		shader_resource_view_desc.Texture2DArray.MipLevels			= source->GetMipDataCount() == 0 ? 1 : static_cast<UINT>(source->GetMipDataCount());
 		shader_resource_view_desc.Texture2DArray.ArraySize			= array_size;
 
 		// Create
@@ -290,7 +293,7 @@ namespace Spartan
 			m_array_size,
 			format,
 			flags,
-			m_data,
+			this,
 			m_rhi_device
 		);
 
@@ -302,7 +305,7 @@ namespace Spartan
                 m_resource_view[0],
                 format_srv,
                 m_array_size,
-                m_data,
+                this,
                 m_rhi_device
             );
         }
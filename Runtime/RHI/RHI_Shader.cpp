@@ -46,6 +46,12 @@ namespace Spartan
 	template <typename T>
 	void RHI_Shader::Compile(const RHI_Shader_Type type, const string& shader)
 	{
+        Compile<T>(type, shader, string());
+	}
+
+	template <typename T>
+	void RHI_Shader::Compile(const RHI_Shader_Type type, const string& shader, const string& source)
+	{
         m_shader_type = type;
         m_vertex_type = RHI_Vertex_Type_To_Enum<T>();
 
@@ -66,7 +72,7 @@ namespace Spartan
 
 		// Compile
         m_compilation_state = Shader_Compilation_Compiling;
-        m_resource          = _Compile(shader);
+        m_resource          = _Compile(shader, source);
         m_compilation_state = m_resource ? Shader_Compilation_Succeeded : Shader_Compilation_Failed;
 
 		// Log compilation result
@@ -113,7 +119,19 @@ namespace Spartan
 	template <typename T>
 	void RHI_Shader::CompileAsync(const RHI_Shader_Type type, const string& shader)
 	{
-		m_context->GetSubsystem<Threading>()->AddTask([this, type, shader]()
+        Threading* threading = m_context->GetSubsystem<Threading>();
+
+        // Shader files are read on the I/O thread, the compiler reads the included files itself
+        if (FileSystem::IsFile(shader))
+        {
+            threading->ReadFileAsync(shader, [this, type, shader](vector<std::byte>&& data)
+            {
+                Compile<T>(type, shader, string(reinterpret_cast<const char*>(data.data()), data.size()));
+            });
+            return;
+        }
+
+		threading->AddTask([this, type, shader]()
 		{
 			Compile<T>(type, shader);
 		});
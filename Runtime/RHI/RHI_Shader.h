@@ -81,8 +81,12 @@ namespace Spartan
 		std::shared_ptr<RHI_Device> m_rhi_device;
 
 	private:
+        // Compiles the source when it's given (read ahead from the file), otherwise the shader (a file or a source)
+        template<typename T>
+        void Compile(RHI_Shader_Type type, const std::string& shader, const std::string& source);
+
         // All compile functions resolve to this, and this is the underlying API implements
-		void* _Compile(const std::string& shader);
+		void* _Compile(const std::string& shader, const std::string& source);
 		void _Reflect(const RHI_Shader_Type shader_type, const uint32_t* ptr, uint32_t size);
 
 		std::string m_name;
@@ -47,54 +47,30 @@ namespace Spartan
 
 	bool RHI_Texture::SaveToFile(const string& file_path)
 	{
-		// Check to see if the file already exists (if so, get the byte count)
-		uint32_t byte_count = 0;
-		{
-			if (FileSystem::Exists(file_path))
-			{
-				auto file = make_unique<FileStream>(file_path, FileStream_Read);
-				if (file->IsOpen())
-				{
-					file->Read(&byte_count);
-				}
-			}
-		}
+		// The bytes are freed once saved (or uploaded when loading a native file), so
+		// if we hold none and the file already exists, it's already up to date.
+		if (m_data.empty() && FileSystem::Exists(file_path))
+			return true;
 
-		auto append = true;
-		auto file = make_unique<FileStream>(file_path, FileStream_Write | FileStream_Append);
+		// Written uncompressed, texel data barely shrinks and loading maps the file and uses the mips in place
+		auto file = make_unique<FileStream>(file_path, FileStream_Write);
 		if (!file->IsOpen())
 			return false;
 
-		// If the existing file has a byte count but we 
-		// hold no data, don't overwrite the file's bytes.
-		if (byte_count != 0 && m_data.empty())
-		{
-			file->Skip
-			(
-				sizeof(uint32_t) +	// byte count
-				sizeof(uint32_t) +	// mipmap count
-				byte_count			// bytes
-			);
-		}
-		else
+		// Write byte count
+		file->Write(GetByteCount());
+		// Write mipmap count
+		file->Write(static_cast<uint32_t>(m_data.size()));
+		// Write bytes
+		for (auto& mip : m_data)
 		{
-			byte_count = GetByteCount();
-
-			// Write byte count
-			file->Write(byte_count);
-			// Write mipmap count
-			file->Write(static_cast<uint32_t>(m_data.size()));
-			// Write bytes
-			for (auto& mip : m_data)
-			{
-				file->Write(mip);
-			}
-
-			// The bytes have been saved, so we can now free some memory
-			m_data.clear();
-			m_data.shrink_to_fit();
+			file->Write(mip);
 		}
 
+		// The bytes have been saved, so we can now free some memory
+		m_data.clear();
+		m_data.shrink_to_fit();
+
 		// Write properties
 		file->Write(m_bits_per_channel);
 		file->Write(m_width);
@@ -109,9 +85,19 @@ namespace Spartan
 	}
 
 	bool RHI_Texture::LoadFromFile(const string& path)
+	{
+		return Load(path, nullptr, 0);
+	}
+
+	bool RHI_Texture::LoadFromMemory(const string& path, const std::byte* data, const uint64_t size)
+	{
+		return Load(path, data, size);
+	}
+
+	bool RHI_Texture::Load(const string& path, const std::byte* data, const uint64_t size)
 	{
 		// Validate file path
-		if (!FileSystem::IsFile(path))
+		if (!data && !FileSystem::IsFile(path))
 		{
 			LOG_ERROR("\"%s\" is not a valid file path.", path.c_str());
 			return false;
@@ -121,11 +107,21 @@ namespace Spartan
 		m_data.shrink_to_fit();
 		m_load_state = LoadState_Started;
 
+        // Unmaps the native file once the GPU resource has been created (or failed to)
+        const auto release_mapped = [this]()
+        {
+            m_data_mapped.clear();
+            m_data_mapped.shrink_to_fit();
+            m_data_mapped_source = nullptr;
+        };
+
 		// Load from disk
 		auto texture_data_loaded = false;		
 		if (FileSystem::IsEngineTextureFile(path)) // engine format (binary)
 		{
-			texture_data_loaded = LoadFromFile_NativeFormat(path);
+            // Bytes which were read ahead are used in place, like a mapped file
+            auto file           = data ? make_shared<FileStream>(data, size, FileStream_Read | FileStream_Compressed) : make_shared<FileStream>(path, FileStream_Read | FileStream_Mmap);
+			texture_data_loaded = file->IsOpen() && LoadFromFile_NativeFormat(file);
 		}	
 		else if (FileSystem::IsSupportedImageFile(path)) // foreign format (most known image formats)
 		{
@@ -136,14 +132,17 @@ namespace Spartan
 		if (!texture_data_loaded)
 		{
 			LOG_ERROR("Failed to load \"%s\".", path.c_str());
+            release_mapped();
 			m_load_state = LoadState_Failed;
 			return false;
 		}
 
-        m_mip_levels = static_cast<uint32_t>(m_data.size());
+        m_mip_levels = GetMipDataCount();
 
 		// Create GPU resource
-        if (!m_context->GetSubsystem<Renderer>()->GetRhiDevice()->IsInitialized() || !CreateResourceGpu())
+        const bool created = m_context->GetSubsystem<Renderer>()->GetRhiDevice()->IsInitialized() && CreateResourceGpu();
+        release_mapped();
+        if (!created)
         {
             LOG_ERROR("Failed to create shader resource for \"%s\".", GetResourceFilePathNative().c_str());
             m_load_state = LoadState_Failed;
@@ -186,6 +185,14 @@ namespace Spartan
 		return &m_data[index];
 	}
 
+    const std::byte* RHI_Texture::GetMipData(const uint32_t mip) const
+    {
+        if (!m_data_mapped.empty())
+            return mip < m_data_mapped.size() ? m_data_mapped[mip] : nullptr;
+
+        return (mip < m_data.size() && !m_data[mip].empty()) ? m_data[mip].data() : nullptr;
+    }
+
     vector<std::byte> RHI_Texture::GetMipmap(const uint32_t index)
     {
         vector<std::byte> data;
@@ -239,25 +246,37 @@ namespace Spartan
 		return true;
 	}
 
-	bool RHI_Texture::LoadFromFile_NativeFormat(const string& file_path)
+	bool RHI_Texture::LoadFromFile_NativeFormat(const shared_ptr<FileStream>& file)
 	{
-		auto file = make_unique<FileStream>(file_path, FileStream_Read);
-		if (!file->IsOpen())
-			return false;
-
 		m_data.clear();
 		m_data.shrink_to_fit();
+        m_data_mapped.clear();
 
 		// Read byte and mipmap count
 		auto byte_count = file->ReadAs<uint32_t>();
         const auto mip_count  = file->ReadAs<uint32_t>();
 
-		// Read bytes
-		m_data.resize(mip_count);
-		for (auto& mip : m_data)
-		{
-			file->Read(&mip);
-		}
+		// Read bytes, when the file is mapped the mips point straight into it and the upload reads from the mapped pages
+        if (file->IsMemoryBacked())
+        {
+            m_data_mapped.resize(mip_count);
+            for (auto& mip : m_data_mapped)
+            {
+                uint32_t size = 0;
+                mip = file->ReadView<std::byte>(&size);
+                if (!mip)
+                    return false;
+            }
+            m_data_mapped_source = file;
+        }
+        else
+        {
+		    m_data.resize(mip_count);
+		    for (auto& mip : m_data)
+		    {
+			    file->Read(&mip);
+		    }
+        }
 
 		// Read properties
 		file->Read(&m_bits_per_channel);
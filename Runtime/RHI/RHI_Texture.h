@@ -31,6 +31,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace Spartan
 {
+    class FileStream;
+
 	enum RHI_Texture_Flags : uint16_t
 	{
 		RHI_Texture_ShaderView			        = 1 << 0,
@@ -59,6 +61,8 @@ namespace Spartan
 		//= IResource ===========================================
 		bool SaveToFile(const std::string& file_path) override;
 		bool LoadFromFile(const std::string& file_path) override;
+		bool LoadFromMemory(const std::string& file_path, const std::byte* data, uint64_t size) override;
+		bool CanLoadFromMemory(const std::string& file_path) const override { return FileSystem::IsEngineTextureFile(file_path); }
 		//=======================================================
 
 		auto GetWidth() const											{ return m_width; }
@@ -85,7 +89,7 @@ namespace Spartan
 		void SetFormat(const RHI_Format format)							{ m_format = format; }
 
 		// Data
-        bool HasData() const                                            { return !m_data.empty(); }
+        bool HasData() const                                            { return !m_data.empty() || !m_data_mapped.empty(); }
 		const auto& GetData() const										{ return m_data; }		
         void SetData(const std::vector<std::vector<std::byte>>& data)   { m_data = data; }
         auto AddMipmap()                                                { return &m_data.emplace_back(std::vector<std::byte>()); }
@@ -94,6 +98,10 @@ namespace Spartan
         std::vector<std::byte>* GetData(uint32_t mipmap_index);
         std::vector<std::byte> GetMipmap(uint32_t index);
 
+        // Mip data for GPU uploads, either owned or pointing straight into a memory mapped native file while loading
+        const std::byte* GetMipData(uint32_t mip) const;
+        uint32_t GetMipDataCount() const { return static_cast<uint32_t>(m_data_mapped.empty() ? m_data.size() : m_data_mapped.size()); }
+
         // Binding type
         bool IsSampled()                    const { return m_flags & RHI_Texture_ShaderView; }
         bool IsRenderTargetCompute()        const { return m_flags & RHI_Texture_UnorderedAccessView; }
@@ -125,7 +133,8 @@ namespace Spartan
         void* Get_Resource_View_RenderTarget(const uint32_t i = 0)          const { return i < m_resource_view_renderTarget.size() ? m_resource_view_renderTarget[i] : nullptr; }
 
 	protected:
-		bool LoadFromFile_NativeFormat(const std::string& file_path);
+		bool Load(const std::string& file_path, const std::byte* data, uint64_t size);
+		bool LoadFromFile_NativeFormat(const std::shared_ptr<FileStream>& file);
 		bool LoadFromFile_ForeignFormat(const std::string& file_path, bool generate_mipmaps);
 		static uint32_t GetChannelCountFromFormat(RHI_Format format);
         virtual bool CreateResourceGpu() { LOG_ERROR("Function not implemented by API"); return false; }
@@ -141,6 +150,8 @@ namespace Spartan
         uint16_t m_flags	        = 0;
 		RHI_Viewport m_viewport;
 		std::vector<std::vector<std::byte>> m_data;
+        std::vector<const std::byte*> m_data_mapped;
+        std::shared_ptr<FileStream> m_data_mapped_source;
 		std::shared_ptr<RHI_Device> m_rhi_device;
 
         // API
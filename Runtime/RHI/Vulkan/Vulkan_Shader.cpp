@@ -343,7 +343,7 @@ namespace Spartan
 		};
 	}
 	
-	void* RHI_Shader::_Compile(const string& shader)
+	void* RHI_Shader::_Compile(const string& shader, const string& source)
 	{
 		// Deduce some things
         const auto is_file	    = FileSystem::IsSupportedShaderFile(shader);
@@ -410,7 +410,11 @@ namespace Spartan
 		CComPtr<IDxcBlobEncoding> shader_blob = nullptr;
 		{
 			HRESULT result;
-			if (is_file)
+			if (is_file && !source.empty()) // read ahead
+			{
+				result = DxShaderCompiler::Instance::Get().library->CreateBlobWithEncodingFromPinned(source.c_str(), static_cast<uint32_t>(source.size()), CP_UTF8, &shader_blob);
+			}
+			else if (is_file)
 			{
                 const auto file_path = FileSystem::StringToWstring(shader);				
 				result = DxShaderCompiler::Instance::Get().library->CreateBlobFromFile(file_path.c_str(), nullptr, &shader_blob);
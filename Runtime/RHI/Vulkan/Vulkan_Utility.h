@@ -847,7 +847,7 @@ namespace Spartan::vulkan_utility
                         uint32_t index          = array_index + mip_index;
                         uint64_t memory_size    = (width >> mip_index) * (height >> mip_index) * bytes_per_pixel;
                         uint64_t memory_offset  = mip_index != 0 ? (width >> (mip_index - 1)) * (height >> (mip_index - 1)) * bytes_per_pixel : 0;
-                        memcpy(static_cast<std::byte*>(data) + memory_offset, texture->GetData(index)->data(), memory_size);
+                        memcpy(static_cast<std::byte*>(data) + memory_offset, texture->GetMipData(index), memory_size);
                     }
                 }
 
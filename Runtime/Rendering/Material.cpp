@@ -65,6 +65,7 @@ namespace Spartan
 
 		SetResourceFilePath(file_path);
 
+        const bool was_transparent = m_color_albedo.w < 1.0f;
         xml->GetAttribute("Material", "Color",                          &m_color_albedo);
 		xml->GetAttribute("Material", "Roughness_Multiplier",	        &GetProperty(Material_Roughness));
 		xml->GetAttribute("Material", "Metallic_Multiplier",	        &GetProperty(Material_Metallic));
@@ -89,11 +90,11 @@ namespace Spartan
 			auto tex_path		                = xml->GetAttributeAs<string>(node_name, "Texture_Path");
 
 			// If the texture happens to be loaded, get a reference to it
-			auto texture = m_context->GetSubsystem<ResourceCache>()->GetByName<RHI_Texture2D>(tex_name);
-			// If there is not texture (it's not loaded yet), load it
+			shared_ptr<RHI_Texture2D> texture = m_context->GetSubsystem<ResourceCache>()->GetByName<RHI_Texture2D>(tex_name);
+			// If there is not texture (it's not loaded yet), start loading it, the renderer uses a placeholder until it's done
 			if (!texture)
 			{
-				texture = m_context->GetSubsystem<ResourceCache>()->Load<RHI_Texture2D>(tex_path);
+				texture = m_context->GetSubsystem<ResourceCache>()->LoadAsync<RHI_Texture2D>(tex_path).Get();
 			}
 			SetTextureSlot(tex_type, texture, GetProperty(tex_type));
 		}
@@ -101,6 +102,12 @@ namespace Spartan
         // Ensure an a suitable shader exists
         ShaderGBuffer::GenerateVariation(m_context, m_flags);
 
+        // A reload can switch the render mode of the entities that already use this material
+        if (was_transparent != (m_color_albedo.w < 1.0f))
+        {
+            FIRE_EVENT(Event_Material_Transparency_Changed);
+        }
+
         m_size_cpu = sizeof(*this);
 
 		return true;
@@ -147,8 +154,8 @@ namespace Spartan
 	{
 		if (texture)
 		{
-            // In order for the material to guarantee serialization/deserialization we cache the texture
-            const shared_ptr<RHI_Texture> texture_cached = m_context->GetSubsystem<ResourceCache>()->Cache(texture);
+            // In order for the material to guarantee serialization/deserialization we cache the texture (textures which are still loading cache themselves)
+            const shared_ptr<RHI_Texture> texture_cached = texture->GetLoadState() != LoadState_Started ? m_context->GetSubsystem<ResourceCache>()->Cache(texture) : nullptr;
 			m_textures[type] = texture_cached != nullptr ? texture_cached : texture;
             m_flags |= type;
 
@@ -216,15 +223,25 @@ namespace Spartan
         return HasTexture(type) ? m_textures.at(type) : texture_empty;
     }
 
+    RHI_Texture* Material::GetTexture_Ptr(const Material_Property type)
+    {
+        // Textures which are still loading return null, so that a placeholder is bound instead
+        if (!HasTexture(type) || m_textures[type]->GetLoadState() == LoadState_Started)
+            return nullptr;
+
+        m_textures[type]->MarkUsed();
+        return m_textures[type].get();
+    }
+
     void Material::SetColorAlbedo(const Math::Vector4& color)
     {
-        // If an object switches from opaque to transparent or vice versa, make the world update so that the renderer
-        // goes through the entities and makes the ones that use this material, render in the correct mode.
-        if ((m_color_albedo.w != 1.0f && color.w == 1.0f) || (m_color_albedo.w == 1.0f && color.w != 1.0f))
+        // Let the renderer move the entities that use this material to the other render mode
+        const bool transparency_changed = (m_color_albedo.w < 1.0f) != (color.w < 1.0f);
+        m_color_albedo = color;
+
+        if (transparency_changed)
         {
-            m_context->GetSubsystem<World>()->MakeDirty();
+            FIRE_EVENT(Event_Material_Transparency_Changed);
         }
-
-        m_color_albedo = color;
     }
 }
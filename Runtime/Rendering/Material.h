@@ -72,7 +72,7 @@ namespace Spartan
         bool HasTexture(const Material_Property type) const { return m_flags & type; }
 		std::string GetTexturePathByType(Material_Property type);
 		std::vector<std::string> GetTexturePaths();
-		RHI_Texture* GetTexture_Ptr(const Material_Property type) { return HasTexture(type) ? m_textures[type].get() : nullptr; }
+		RHI_Texture* GetTexture_Ptr(const Material_Property type);
         std::shared_ptr<RHI_Texture>& GetTexture_PtrShared(const Material_Property type);
 		//=======================================================================================================================
         
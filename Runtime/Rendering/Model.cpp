@@ -79,8 +79,8 @@ namespace Spartan
         // Load engine format
         if (FileSystem::GetExtensionFromFilePath(file_path) == EXTENSION_MODEL)
         {
-            // Deserialize
-            auto file = make_unique<FileStream>(file_path, FileStream_Read);
+            // Deserialize, the geometry is copied straight from the mapped file into the mesh (which keeps it for physics and queries)
+            auto file = make_unique<FileStream>(file_path, FileStream_Read | FileStream_Mmap);
             if (!file->IsOpen())
                 return false;
 
@@ -129,7 +129,7 @@ namespace Spartan
 
 	bool Model::SaveToFile(const string& file_path)
 	{
-		auto file = make_unique<FileStream>(file_path, FileStream_Write);
+		auto file = make_unique<FileStream>(file_path, FileStream_Write | FileStream_Compressed);
 		if (!file->IsOpen())
 			return false;
 
@@ -204,16 +204,10 @@ namespace Spartan
 		{
 			material->SetTextureSlot(texture_type, texture);
 		}
-		// If we didn't get a texture, it's not cached, hence we have to load it and cache it now
-		else
+		// If we didn't get a texture, it's not cached, hence we have to load it, the material gets it right away and renders with a placeholder until it's done
+		else if (auto texture_loading = m_context->GetSubsystem<ResourceCache>()->LoadAsync<RHI_Texture2D>(file_path).Get())
 		{
-			// Load texture
-			auto generate_mipmaps = true;
-            texture = make_shared<RHI_Texture2D>(m_context, generate_mipmaps);
-			texture->LoadFromFile(file_path);
-
-			// Set the texture to the provided material
-			material->SetTextureSlot(texture_type, texture);
+			material->SetTextureSlot(texture_type, texture_loading);
 		}
 	}
 
@@ -31,6 +31,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Resource/ResourceCache.h"
 #include "../Core/Engine.h"
 #include "../Core/Timer.h"
+#include "../World/World.h"
 #include "../World/Entity.h"
 #include "../World/Components/Transform.h"
 #include "../World/Components/Renderable.h"
@@ -54,8 +55,24 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    static const uint32_t entity_slot_none = numeric_limits<uint32_t>::max();
+    static const float sort_camera_distance = 1.0f; // how far the camera has to move before the renderables are re-sorted
+
+    static Renderer_Object_Type get_renderable_type(Entity* entity)
+    {
+        const Material* material = entity->GetRenderable()->GetMaterial();
+        return (material && material->GetColorAlbedo().w < 1.0f) ? Renderer_Object_Transparent : Renderer_Object_Opaque;
+    }
+
     Renderer::Renderer(Context* context) : ISubsystem(context)
     {
+        // Reads the world and its resources to draw them, the rhi immediate context lives on the main thread
+        SetTickDependencies(
+            SubsystemData_Time | SubsystemData_Input | SubsystemData_World | SubsystemData_Resources | SubsystemData_Physics | SubsystemData_Profiling,
+            SubsystemData_Rendering,
+            true
+        );
+
         // Options
         m_options |= Render_ReverseZ;
         //m_options |= Render_DepthPrepass;
@@ -88,16 +105,19 @@ namespace Spartan
         m_option_values[Option_Value_Motion_Blur_Intensity]   = 0.01f;
 
 		// Subscribe to events
-		SUBSCRIBE_TO_EVENT(Event_World_Resolve_Complete,    EVENT_HANDLER_VARIANT(RenderablesAcquire));
-        SUBSCRIBE_TO_EVENT(Event_World_Unload,              EVENT_HANDLER(ClearEntities));
+		m_event_world_resolve_complete  = SUBSCRIBE_TO_EVENT(Event_World_Resolve_Complete,  EVENT_HANDLER_VARIANT(RenderablesAcquire));
+        m_event_world_unload            = SUBSCRIBE_TO_EVENT(Event_World_Unload,            EVENT_HANDLER(ClearEntities));
+        m_event_material_transparency   = SUBSCRIBE_TO_EVENT(Event_Material_Transparency_Changed, [this](Variant) { m_entities_reclassify = true; });
 	}
 
 	Renderer::~Renderer()
 	{
 		// Unsubscribe from events
-		UNSUBSCRIBE_FROM_EVENT(Event_World_Resolve_Complete, EVENT_HANDLER_VARIANT(RenderablesAcquire));
+		UNSUBSCRIBE_FROM_EVENT(m_event_world_resolve_complete);
+		UNSUBSCRIBE_FROM_EVENT(m_event_world_unload);
+		UNSUBSCRIBE_FROM_EVENT(m_event_material_transparency);
 
-		m_entities.clear();
+		ClearEntities();
 		m_camera = nullptr;
 
 		// Log to file as the renderer is no more
@@ -240,6 +260,9 @@ namespace Spartan
             m_buffer_frame_cpu.view_projection_unjittered   = m_buffer_frame_cpu.view * m_camera->GetProjectionMatrix();
 		}
 
+        // Only re-sorts when the buckets changed or the camera moved far enough
+        RenderablesSort();
+
 		m_is_rendering = true;
 		Pass_Main(cmd_list);
 		m_is_rendering = false;
@@ -507,72 +530,200 @@ namespace Spartan
         return m_buffer_light_gpu->Unmap();
     }
 
-	void Renderer::RenderablesAcquire(const Variant& entities_variant)
+	void Renderer::RenderablesAcquire(const Variant& resolve_variant)
 	{
         SCOPED_TIME_BLOCK(m_profiler);
 
-		// Clear previous state
-		m_entities.clear();
-		m_camera = nullptr;
+		const WorldResolve* resolve = resolve_variant.Get<const WorldResolve*>();
 
-		vector<shared_ptr<Entity>> entities = entities_variant.Get<vector<shared_ptr<Entity>>>();
-		for (const auto& entity : entities)
+		// Only touch the entities which changed since the last resolve
+		if (!resolve->full)
 		{
-			if (!entity || !entity->IsActive())
-				continue;
+			for (const auto& entity : resolve->removed)
+			{
+				RenderableRemove(entity.get());
+			}
 
-			// Get all the components we are interested in
-            Renderable* renderable  = entity->GetComponent<Renderable>();
-            Light* light            = entity->GetComponent<Light>();
-            Camera* camera          = entity->GetComponent<Camera>();
+			for (const auto& entity : resolve->changed)
+			{
+				RenderableRemove(entity.get());
+				RenderableAdd(entity.get());
+			}
 
-			if (renderable)
+			for (const auto& entity : resolve->added)
 			{
-                bool is_transparent = false;
+				RenderableAdd(entity.get());
+			}
 
-                if (const Material* material = renderable->GetMaterial())
-                {
-                    is_transparent = material->GetColorAlbedo().w < 1.0f;
-                }
+			const vector<Entity*>& cameras = m_entities[Renderer_Object_Camera];
+			shared_ptr<Camera> camera = cameras.empty() ? nullptr : cameras.back()->GetComponent<Camera>()->GetPtrShared<Camera>();
+			m_entities_sort_dirty |= camera != m_camera;
+			m_camera = move(camera);
+
+			return;
+		}
+
+		// Clear previous state
+		ClearEntities();
+		m_camera = nullptr;
+
+		// Walk the world's packed component arrays instead of looking up each entity's components
+		const World* world = m_context->GetSubsystem<World>();
 
-                m_entities[is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque].emplace_back(entity.get());
+		const ComponentView<Renderable> renderables = world->ComponentGetAll<Renderable>();
+		for (uint32_t i = 0; i < renderables.GetCount(); i++)
+		{
+			Entity* entity = renderables.GetEntity(i);
+			if (entity->IsActive())
+			{
+				RenderableAdd(get_renderable_type(entity), entity);
 			}
+		}
 
-			if (light)
+		const ComponentView<Light> lights = world->ComponentGetAll<Light>();
+		for (uint32_t i = 0; i < lights.GetCount(); i++)
+		{
+			if (lights.GetEntity(i)->IsActive())
 			{
-				m_entities[Renderer_Object_Light].emplace_back(entity.get());
+				RenderableAdd(Renderer_Object_Light, lights.GetEntity(i));
 			}
+		}
 
-			if (camera)
+		const ComponentView<Camera> cameras = world->ComponentGetAll<Camera>();
+		for (uint32_t i = 0; i < cameras.GetCount(); i++)
+		{
+			if (cameras.GetEntity(i)->IsActive())
 			{
-				m_entities[Renderer_Object_Camera].emplace_back(entity.get());
-				m_camera = camera->GetPtrShared<Camera>();
+				RenderableAdd(Renderer_Object_Camera, cameras.GetEntity(i));
+				m_camera = cameras.GetComponent(i)->GetPtrShared<Camera>();
 			}
 		}
+	}
+
+	void Renderer::RenderableAdd(Entity* entity)
+	{
+		if (!entity->IsActive())
+			return;
+
+		if (entity->HasComponent<Renderable>())
+		{
+			RenderableAdd(get_renderable_type(entity), entity);
+		}
 
-		RenderablesSort(&m_entities[Renderer_Object_Opaque]);
-		RenderablesSort(&m_entities[Renderer_Object_Transparent]);
+		if (entity->HasComponent<Light>())
+		{
+			RenderableAdd(Renderer_Object_Light, entity);
+		}
+
+		if (entity->HasComponent<Camera>())
+		{
+			RenderableAdd(Renderer_Object_Camera, entity);
+		}
+	}
+
+	void Renderer::RenderableAdd(const Renderer_Object_Type type, Entity* entity)
+	{
+		// Appended, the order is up to RenderablesSort()
+		vector<Entity*>& entities = m_entities[type];
+
+		auto it = m_entity_slots.find(entity);
+		if (it == m_entity_slots.end())
+		{
+			it = m_entity_slots.emplace(entity, array<uint32_t, Renderer_Object_Camera + 1>()).first;
+			it->second.fill(entity_slot_none);
+		}
+
+		it->second[type] = static_cast<uint32_t>(entities.size());
+		entities.emplace_back(entity);
+
+		m_entities_sort_dirty |= type == Renderer_Object_Opaque || type == Renderer_Object_Transparent;
 	}
 
-	void Renderer::RenderablesSort(vector<Entity*>* renderables)
+	void Renderer::RenderableRemove(Entity* entity)
 	{
-		if (!m_camera || renderables->size() <= 2)
+		auto it = m_entity_slots.find(entity);
+		if (it == m_entity_slots.end())
 			return;
 
-		auto comparison_op = [this](Entity* entity)
+		for (uint32_t type = 0; type < it->second.size(); type++)
 		{
-			auto renderable = entity->GetRenderable();
-			if (!renderable)
-				return 0.0f;
+			const uint32_t slot = it->second[type];
+			if (slot == entity_slot_none)
+				continue;
 
-			return (renderable->GetAabb().GetCenter() - m_camera->GetTransform()->GetPosition()).LengthSquared();
-		};
+			// Swap and pop
+			vector<Entity*>& entities   = m_entities[static_cast<Renderer_Object_Type>(type)];
+			Entity* entity_last         = entities.back();
+			entities[slot]              = entity_last;
+			m_entity_slots.find(entity_last)->second[type] = slot;
+			entities.pop_back();
 
-		// Sort by depth (front to back)
-		sort(renderables->begin(), renderables->end(), [&comparison_op](Entity* a, Entity* b)
+			m_entities_sort_dirty |= type == Renderer_Object_Opaque || type == Renderer_Object_Transparent;
+		}
+
+		m_entity_slots.erase(it);
+	}
+
+	void Renderer::RenderablesSort()
+	{
+		// Only a material switching between opaque and transparent requires the buckets to be checked
+		if (m_entities_reclassify.exchange(false))
 		{
-            return comparison_op(a) < comparison_op(b);
-		});
+			vector<Entity*> entities_moved;
+			for (const Renderer_Object_Type type : { Renderer_Object_Opaque, Renderer_Object_Transparent })
+			{
+				for (Entity* entity : m_entities[type])
+				{
+					if (get_renderable_type(entity) != type)
+					{
+						entities_moved.emplace_back(entity);
+					}
+				}
+			}
+
+			for (Entity* entity : entities_moved)
+			{
+				RenderableRemove(entity);
+				RenderableAdd(entity);
+			}
+		}
+
+		if (!m_camera)
+			return;
+
+		// The order only has to be rebuilt when entities came and went or the camera moved noticeably
+		const Vector3 camera_position = m_camera->GetTransform()->GetPosition();
+		if (!m_entities_sort_dirty && (camera_position - m_entities_sort_camera_position).LengthSquared() < sort_camera_distance * sort_camera_distance)
+			return;
+
+		m_entities_sort_dirty           = false;
+		m_entities_sort_camera_position = camera_position;
+
+		// Sort by depth (front to back), with each distance computed once instead of in every comparison
+		for (const Renderer_Object_Type type : { Renderer_Object_Opaque, Renderer_Object_Transparent })
+		{
+			vector<Entity*>& entities = m_entities[type];
+			if (entities.size() <= 1)
+				continue;
+
+			m_entities_sort.clear();
+			for (Entity* entity : entities)
+			{
+				const Renderable* renderable = entity->GetRenderable();
+				m_entities_sort.emplace_back(renderable ? (renderable->GetAabb().GetCenter() - camera_position).LengthSquared() : 0.0f, entity);
+			}
+
+			sort(m_entities_sort.begin(), m_entities_sort.end(), [](const pair<float, Entity*>& a, const pair<float, Entity*>& b)
+			{
+				return a.first < b.first;
+			});
+
+			for (uint32_t i = 0; i < static_cast<uint32_t>(m_entities_sort.size()); i++)
+			{
+				entities[i] = m_entities_sort[i].second;
+				m_entity_slots.find(entities[i])->second[type] = i;
+			}
+		}
 	}
 
     const shared_ptr<Spartan::RHI_Texture>& Renderer::GetEnvironmentTexture()
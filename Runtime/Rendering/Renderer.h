@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Renderer_ConstantBuffers.h"
 #include "Material.h"
 #include "../Core/ISubsystem.h"
+#include "../Core/EventSystem.h"
 #include "../Math/Rectangle.h"
 #include "../RHI/RHI_Definition.h"
 #include "../RHI/RHI_Viewport.h"
@@ -324,9 +325,12 @@ namespace Spartan
         bool UpdateLightBuffer(const Light* light);
 
         // Misc
-        void RenderablesAcquire(const Variant& renderables);
-        void RenderablesSort(std::vector<Entity*>* renderables);
-        void ClearEntities() { m_entities.clear(); }
+        void RenderablesAcquire(const Variant& resolve);
+        void RenderablesSort();
+        void RenderableAdd(Entity* entity);
+        void RenderableAdd(Renderer_Object_Type type, Entity* entity);
+        void RenderableRemove(Entity* entity);
+        void ClearEntities() { m_entities.clear(); m_entity_slots.clear(); m_entities_sort_dirty = true; }
 
         // Render textures
         std::unordered_map<Renderer_RenderTarget_Type, std::shared_ptr<RHI_Texture>> m_render_targets;
@@ -429,10 +433,20 @@ namespace Spartan
 
         // Entities and material references
         std::unordered_map<Renderer_Object_Type, std::vector<Entity*>> m_entities;
+        std::unordered_map<Entity*, std::array<uint32_t, Renderer_Object_Camera + 1>> m_entity_slots; // where each entity is in the buckets
+        std::vector<std::pair<float, Entity*>> m_entities_sort;
+        Math::Vector3 m_entities_sort_camera_position   = Math::Vector3::Zero;
+        bool m_entities_sort_dirty                      = true;
+        std::atomic<bool> m_entities_reclassify         = false;
         std::array<Material*, m_max_materials> m_materials;
         
         std::shared_ptr<Camera> m_camera;
 
+        // Events
+        EventHandle m_event_world_resolve_complete;
+        EventHandle m_event_world_unload;
+        EventHandle m_event_material_transparency;
+
         // RHI Core
         std::shared_ptr<RHI_Device> m_rhi_device;
         std::shared_ptr<RHI_SwapChain> m_swap_chain;
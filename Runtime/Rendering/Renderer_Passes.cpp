@@ -451,6 +451,10 @@ namespace Spartan
                     cmd_list->SetBufferIndex(model->GetIndexBuffer());
                     cmd_list->SetBufferVertex(model->GetVertexBuffer());
 
+                    // Keep what's rendered at the front of the resource cache's eviction order
+                    model->MarkUsed();
+                    material->MarkUsed();
+
                     // Bind material
                     bool is_dirty = material_index == 1 ? true : (m_materials[material_index - 1]->GetId() != material->GetId());
                     if (is_dirty)
@@ -35,6 +35,8 @@ using namespace std;
 using namespace Spartan;
 //=======================
 
+atomic<uint64_t> IResource::m_frame(0);
+
 IResource::IResource(Context* context, const Resource_Type type)
 {
 	m_context		= context;
@@ -23,6 +23,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ===================
 #include <memory>
+#include <atomic>
+#include <cstddef>
 #include "../Core/Context.h"
 #include "../Core/FileSystem.h"
 #include "../Core/Spartan_Object.h"
@@ -104,11 +106,22 @@ namespace Spartan
 
 
         // Misc
-		LoadState GetLoadState() const { return m_load_state; }
+		LoadState GetLoadState() const              { return m_load_state.load(std::memory_order_acquire); }
+        void SetLoadState(const LoadState state)    { m_load_state.store(state, std::memory_order_release); }
+
+        // Usage, the resource cache evicts the least recently used resources first
+        void MarkUsed() const                       { m_frame_used.store(m_frame.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+        uint64_t GetFrameUsed() const               { return m_frame_used.load(std::memory_order_relaxed); }
+        static uint64_t GetFrame()                  { return m_frame.load(std::memory_order_relaxed); }
+        static void AdvanceFrame()                  { m_frame.fetch_add(1, std::memory_order_relaxed); }
 
 		// IO
 		virtual bool SaveToFile(const std::string& file_path)	{ return true; }
 		virtual bool LoadFromFile(const std::string& file_path)	{ return true; }
+        // Loads from the bytes of the file, which were read ahead (e.g. on the I/O thread) and only have to outlive the call
+        virtual bool LoadFromMemory(const std::string& file_path, const std::byte* data, uint64_t size) { return LoadFromFile(file_path); }
+        // Whether LoadFromMemory() parses the bytes itself, if not, the file is read again and reading it ahead is wasted
+        virtual bool CanLoadFromMemory(const std::string& file_path) const { return false; }
 
 		// Type
 		template <typename T>
@@ -116,7 +129,9 @@ namespace Spartan
 
 	protected:
 		Resource_Type m_resource_type	= Resource_Unknown;
-		LoadState m_load_state			= LoadState_Idle;
+		std::atomic<LoadState> m_load_state	= LoadState_Idle; // once completed, other threads can use the resource
+        mutable std::atomic<uint64_t> m_frame_used = 0;
+        static std::atomic<uint64_t> m_frame;
 
 	private:
 		std::string m_resource_name;
@@ -29,6 +29,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Core/Settings.h"
 #include "../../Math/MathHelper.h"
 #include "../../RHI/RHI_Texture2D.h"
+#include "../../IO/FileStream.h"
+#include "../ResourceCache.h"
+#include "ImportCache.h"
 //====================================
 
 //= NAMESPACES =====
@@ -39,6 +42,9 @@ namespace Spartan::freeimage_helper
 {
 	static FREE_IMAGE_FILTER rescale_filter = FILTER_LANCZOS3;
 
+    // Bump whenever the output changes, so that stale import cache entries are ignored
+    static const uint32_t import_version = 1;
+
 	// A struct that rescaling threads will work with
 	struct RescaleJob
 	{
@@ -46,7 +52,7 @@ namespace Spartan::freeimage_helper
 		uint32_t height		    = 0;
 		uint32_t channel_count	= 0;
 		vector<std::byte>* data	= nullptr;
-		bool done			    = false;
+		TaskHandle task;
 
 		RescaleJob(const uint32_t width, const uint32_t height, const uint32_t channel_count)
 		{
@@ -166,6 +172,12 @@ namespace Spartan
 			return false;
 		}
 
+        // If the same image was already imported with the same settings, skip decoding and mipmap generation
+        const uint64_t import_flags = static_cast<uint64_t>(generate_mipmaps) | (static_cast<uint64_t>(texture->GetWidth()) << 1) | (static_cast<uint64_t>(texture->GetHeight()) << 32);
+        const ImportCacheEntry import_entry = m_context->GetSubsystem<ResourceCache>()->GetImportCache()->Lookup(file_path, freeimage_helper::import_version, import_flags, ".texture_import");
+        if (import_entry.hit && LoadFromImportCache(import_entry.path, texture))
+            return true;
+
 		// Acquire image format
 		auto format	= FreeImage_GetFileType(file_path.c_str(), 0);
 		format		= (format == FIF_UNKNOWN) ? FreeImage_GetFIFFromFilename(file_path.c_str()) : format;  // If the format is unknown, try to get it from the the filename	
@@ -232,9 +244,63 @@ namespace Spartan
 		texture->SetFormat(image_format);
 		texture->SetGrayscale(image_is_grayscale);
 
+        if (!import_entry.path.empty())
+        {
+            SaveToImportCache(import_entry, texture);
+        }
+
 		return true;
 	}
 
+    bool ImageImporter::LoadFromImportCache(const string& file_path, RHI_Texture* texture) const
+    {
+        auto file = make_unique<FileStream>(file_path, FileStream_Read);
+        if (!file->IsOpen())
+            return false;
+
+        const auto mip_count = file->ReadAs<uint32_t>();
+        for (uint32_t i = 0; i < mip_count; i++)
+        {
+            file->Read(texture->AddMipmap());
+        }
+
+        texture->SetBitsPerChannel(file->ReadAs<uint32_t>());
+        texture->SetWidth(file->ReadAs<uint32_t>());
+        texture->SetHeight(file->ReadAs<uint32_t>());
+        texture->SetChannelCount(file->ReadAs<uint32_t>());
+        texture->SetFormat(static_cast<RHI_Format>(file->ReadAs<uint32_t>()));
+        texture->SetTransparency(file->ReadAs<bool>());
+        texture->SetGrayscale(file->ReadAs<bool>());
+
+        return true;
+    }
+
+    void ImageImporter::SaveToImportCache(const ImportCacheEntry& entry, const RHI_Texture* texture) const
+    {
+        {
+            // Uncompressed like the engine's texture files, so entries can be mapped and read in place
+            auto file = make_unique<FileStream>(entry.path_temp, FileStream_Write);
+            if (!file->IsOpen())
+                return;
+
+            file->Write(static_cast<uint32_t>(texture->GetData().size()));
+            for (const vector<std::byte>& mip : texture->GetData())
+            {
+                file->Write(mip);
+            }
+
+            file->Write(texture->GetBitsPerChannel());
+            file->Write(texture->GetWidth());
+            file->Write(texture->GetHeight());
+            file->Write(texture->GetChannelCount());
+            file->Write(static_cast<uint32_t>(texture->GetFormat()));
+            file->Write(static_cast<bool>(texture->GetTransparency()));
+            file->Write(static_cast<bool>(texture->GetGrayscale()));
+        }
+
+        m_context->GetSubsystem<ResourceCache>()->GetImportCache()->Store(entry);
+    }
+
 	bool ImageImporter::GetBitsFromFibitmap(vector<std::byte>* data, FIBITMAP* bitmap, const uint32_t width, const uint32_t height, const uint32_t channels) const
     {
 		if (!data || width == 0 || height == 0 || channels == 0)
@@ -293,7 +359,7 @@ namespace Spartan
 		auto threading = m_context->GetSubsystem<Threading>();
 		for (auto& job : jobs)
 		{
-			threading->AddTask([this, &job, &bitmap]()
+			job.task = threading->AddTask([this, &job, &bitmap]()
 			{
 				const auto bitmap_scaled = FreeImage_Rescale(bitmap, job.width, job.height, freeimage_helper::rescale_filter);
 				if (!GetBitsFromFibitmap(job.data, bitmap_scaled, job.width, job.height, job.channel_count))
@@ -301,22 +367,13 @@ namespace Spartan
 					LOG_ERROR("Failed to create mip level %dx%d", job.width, job.height);
 				}
 				FreeImage_Unload(bitmap_scaled);
-				job.done = true;
 			});
 		}
 
-		// Wait until all mipmaps have been generated
-		auto ready = false;
-		while (!ready)
+		// Wait until all mipmaps have been generated (this thread helps out while waiting)
+		for (const auto& job : jobs)
 		{
-			ready = true;
-			for (const auto& job : jobs)
-			{
-				if (!job.done)
-				{
-					ready = false;
-				}
-			}
+			threading->Wait(job.task);
 		}
 	}
 
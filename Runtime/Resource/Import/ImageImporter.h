@@ -33,6 +33,7 @@ struct FIBITMAP;
 namespace Spartan
 {
 	class Context;
+    struct ImportCacheEntry;
 
 	class SPARTAN_CLASS ImageImporter
 	{
@@ -48,6 +49,8 @@ namespace Spartan
 		FIBITMAP* ApplyBitmapCorrections(FIBITMAP* bitmap) const;
 		FIBITMAP* _FreeImage_ConvertTo32Bits(FIBITMAP* bitmap) const;
 		FIBITMAP* _FreeImage_Rescale(FIBITMAP* bitmap, uint32_t width, uint32_t height) const;
+        bool LoadFromImportCache(const std::string& file_path, RHI_Texture* texture) const;
+        void SaveToImportCache(const ImportCacheEntry& entry, const RHI_Texture* texture) const;
 
         Context* m_context = nullptr;
 	};
@@ -0,0 +1,101 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ================
+#include "ImportCache.h"
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include "../ResourceCache.h"
+#include "../../Utilities/Hash.h"
+//===========================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+	ImportCache::ImportCache(Context* context)
+	{
+		m_context = context;
+	}
+
+	ImportCacheEntry ImportCache::Lookup(const string& file_path, const uint32_t importer_version, const uint64_t import_flags, const string& extension)
+	{
+        ImportCacheEntry entry;
+
+        ifstream file(file_path, ios::binary);
+        if (!file.is_open())
+        {
+            LOG_ERROR("Failed to open \"%s\".", file_path.c_str());
+            return entry;
+        }
+
+        // Hash the source bytes, whatever the file is called or wherever it lives, the same bytes produce the same output
+        uint64_t hash = Utility::Hash::fnv1a_64(&importer_version, sizeof(importer_version));
+        hash = Utility::Hash::fnv1a_64(&import_flags, sizeof(import_flags), hash);
+        char buffer[64 * 1024];
+        while (file)
+        {
+            file.read(buffer, sizeof(buffer));
+            hash = Utility::Hash::fnv1a_64(buffer, static_cast<size_t>(file.gcount()), hash);
+        }
+
+        const string directory = m_context->GetSubsystem<ResourceCache>()->GetProjectDirectoryAbsolute() + "Cache/";
+        if (!FileSystem::Exists(directory))
+        {
+            FileSystem::CreateDirectory_(directory);
+        }
+
+        char name[17];
+        snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+        entry.path      = directory + name + extension;
+        entry.path_temp = entry.path + "." + to_string(m_temp_count.fetch_add(1, memory_order_relaxed)) + ".tmp"; // unique, the same content can be imported concurrently
+        entry.hit       = FileSystem::IsFile(entry.path);
+
+        (entry.hit ? m_hits : m_misses).fetch_add(1, memory_order_relaxed);
+
+        return entry;
+	}
+
+    bool ImportCache::Store(const ImportCacheEntry& entry)
+    {
+        error_code error;
+        filesystem::rename(entry.path_temp, entry.path, error);
+        if (error)
+        {
+            // A concurrent import of the same content got there first, its output is just as good
+            if (FileSystem::IsFile(entry.path))
+            {
+                filesystem::remove(entry.path_temp, error);
+                return true;
+            }
+
+            LOG_ERROR("Failed to store \"%s\", %s.", entry.path.c_str(), error.message().c_str());
+            filesystem::remove(entry.path_temp, error);
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,63 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES =====================
+#include "../../Core/EngineDefs.h"
+#include <string>
+#include <atomic>
+//================================
+
+namespace Spartan
+{
+	class Context;
+
+    // Where the output of an import is kept
+    struct ImportCacheEntry
+    {
+        std::string path;       // the cached output
+        std::string path_temp;  // written to first and then moved to path, so that an interrupted import never leaves a truncated entry
+        bool hit = false;
+    };
+
+    // Import outputs, keyed by a hash of the source file's bytes, the importer's version and the import flags
+	class SPARTAN_CLASS ImportCache
+	{
+	public:
+		ImportCache(Context* context);
+		~ImportCache() = default;
+
+		ImportCacheEntry Lookup(const std::string& file_path, uint32_t importer_version, uint64_t import_flags, const std::string& extension);
+        bool Store(const ImportCacheEntry& entry);
+
+        // Statistics
+        uint32_t GetHitCount()  const { return m_hits.load(std::memory_order_relaxed); }
+        uint32_t GetMissCount() const { return m_misses.load(std::memory_order_relaxed); }
+
+	private:
+		Context* m_context = nullptr;
+        std::atomic<uint32_t> m_hits        = 0;
+        std::atomic<uint32_t> m_misses      = 0;
+        std::atomic<uint32_t> m_temp_count  = 0;
+	};
+}
@@ -22,10 +22,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =================================
 #include "ModelImporter.h"
 #include <assimp/Importer.hpp>
+#include <assimp/Exporter.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/version.h>
 #include "AssimpHelper.h"
+#include "ImportCache.h"
 #include "../ProgressReport.h"
+#include "../ResourceCache.h"
+#include "../../Utilities/Hash.h"
 #include "../../RHI/RHI_Texture.h"
 #include "../../Core/Settings.h"
 #include "../../Rendering/Model.h"
@@ -120,8 +124,39 @@ namespace Spartan
         // aiProcess_FixInfacingNormals - is not reliable and fails often.
         // aiProcess_OptimizeGraph      - works but because it merges as nodes as possible, you can't really click and select anything other than the entire thing.
 
+        // The post-processed scene is kept in the import cache, so an unchanged model (imported with the same settings and Assimp version) skips post-processing
+        const uint32_t import_version   = aiGetVersionMajor() * 1000 + aiGetVersionMinor();
+        uint64_t import_flags           = static_cast<uint64_t>(importer_flags);
+        const uint32_t revision         = aiGetVersionRevision();
+        import_flags = Utility::Hash::fnv1a_64(&revision, sizeof(revision), import_flags);
+        import_flags = Utility::Hash::fnv1a_64(&params.triangle_limit, sizeof(params.triangle_limit), import_flags);
+        import_flags = Utility::Hash::fnv1a_64(&params.vertex_limit, sizeof(params.vertex_limit), import_flags);
+        import_flags = Utility::Hash::fnv1a_64(&params.max_normal_smoothing_angle, sizeof(params.max_normal_smoothing_angle), import_flags);
+        import_flags = Utility::Hash::fnv1a_64(&params.max_tangent_smoothing_angle, sizeof(params.max_tangent_smoothing_angle), import_flags);
+        ImportCache* import_cache           = m_context->GetSubsystem<ResourceCache>()->GetImportCache();
+        const ImportCacheEntry import_entry = import_cache->Lookup(file_path, import_version, import_flags, ".assbin");
+
 		// Read the 3D model file from disk
-		if (const aiScene* scene = importer.ReadFile(file_path, importer_flags))
+        const aiScene* scene = import_entry.hit ? importer.ReadFile(import_entry.path, 0) : nullptr;
+        if (!scene)
+        {
+            scene = importer.ReadFile(file_path, importer_flags);
+
+            if (scene && !import_entry.path.empty())
+            {
+                Exporter exporter;
+                if (exporter.Export(scene, "assbin", import_entry.path_temp) == aiReturn_SUCCESS)
+                {
+                    import_cache->Store(import_entry);
+                }
+                else
+                {
+                    LOG_WARNING("Failed to add \"%s\" to the import cache, %s", file_path.c_str(), exporter.GetErrorString());
+                }
+            }
+        }
+
+		if (scene)
 		{
 			FIRE_EVENT(Event_World_Stop);
 
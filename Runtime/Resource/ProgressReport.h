@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Core/EngineDefs.h"
 #include <string>
 #include <unordered_map>
+#include <mutex>
 //=============================
 
 namespace Spartan
@@ -64,19 +65,22 @@ namespace Spartan
 
         void Reset(int progressID)
 		{
+			std::lock_guard<std::mutex> lock(m_mutex);
 			m_reports[progressID].Clear();
 		}
 
-		const std::string& GetStatus(int progressID)				{ return m_reports[progressID].status; }
-		void SetStatus(int progressID, const std::string& status)	{ m_reports[progressID].status = status; }
-		void SetJobCount(int progressID, int jobCount)				{ m_reports[progressID].jobCount = jobCount;}
-		void IncrementJobsDone(int progressID)						{ m_reports[progressID].jobsDone++; }
-		void SetJobsDone(int progressID, int jobsDone)				{ m_reports[progressID].jobsDone = jobsDone; }
-		float GetPercentage(int progressID)							{ return static_cast<float>(m_reports[progressID].jobsDone) / static_cast<float>(m_reports[progressID].jobCount); }
-		bool GetIsLoading(int progressID)							{ return m_reports[progressID].isLoading; }
-		void SetIsLoading(int progressID, bool isLoading)			{ m_reports[progressID].isLoading = isLoading; }
+		// Jobs can report from any thread
+		std::string GetStatus(int progressID)						{ std::lock_guard<std::mutex> lock(m_mutex); return m_reports[progressID].status; }
+		void SetStatus(int progressID, const std::string& status)	{ std::lock_guard<std::mutex> lock(m_mutex); m_reports[progressID].status = status; }
+		void SetJobCount(int progressID, int jobCount)				{ std::lock_guard<std::mutex> lock(m_mutex); m_reports[progressID].jobCount = jobCount;}
+		void IncrementJobsDone(int progressID)						{ std::lock_guard<std::mutex> lock(m_mutex); m_reports[progressID].jobsDone++; }
+		void SetJobsDone(int progressID, int jobsDone)				{ std::lock_guard<std::mutex> lock(m_mutex); m_reports[progressID].jobsDone = jobsDone; }
+		float GetPercentage(int progressID)							{ std::lock_guard<std::mutex> lock(m_mutex); return static_cast<float>(m_reports[progressID].jobsDone) / static_cast<float>(m_reports[progressID].jobCount); }
+		bool GetIsLoading(int progressID)							{ std::lock_guard<std::mutex> lock(m_mutex); return m_reports[progressID].isLoading; }
+		void SetIsLoading(int progressID, bool isLoading)			{ std::lock_guard<std::mutex> lock(m_mutex); m_reports[progressID].isLoading = isLoading; }
 
 	private:	
 		std::unordered_map<int, Progress> m_reports;
+		std::mutex m_mutex;
 	};
 }
@@ -21,13 +21,16 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ======================
 #include "ResourceCache.h"
+#include <algorithm>
 #include "ProgressReport.h"
 #include "Import/ImageImporter.h"
 #include "Import/ModelImporter.h"
 #include "Import/FontImporter.h"
+#include "Import/ImportCache.h"
 #include "../World/World.h"
 #include "../World/Entity.h"
 #include "../IO/FileStream.h"
+#include "../IO/Archive.h"
 #include "../RHI/RHI_Texture2D.h"
 #include "../RHI/RHI_TextureCube.h"
 #include "../Audio/AudioClip.h"
@@ -43,6 +46,9 @@ namespace Spartan
 {
 	ResourceCache::ResourceCache(Context* context) : ISubsystem(context)
 	{
+        // Doesn't tick, still ordered after the timer like the rest of its tick group
+        SetTickDependencies(SubsystemData_Time, SubsystemData_None);
+
         const string data_dir = "Data/";
 
 		// Add engine standard resource directories
@@ -58,24 +64,40 @@ namespace Spartan
 		SetProjectDirectory("Project/");
 
 		// Subscribe to events
-		SUBSCRIBE_TO_EVENT(Event_World_Save,	EVENT_HANDLER(SaveResourcesToFiles));
-		SUBSCRIBE_TO_EVENT(Event_World_Load,	EVENT_HANDLER(LoadResourcesFromFiles));
-		SUBSCRIBE_TO_EVENT(Event_World_Unload,	EVENT_HANDLER(Clear));
+		m_event_world_save      = SUBSCRIBE_TO_EVENT(Event_World_Save,	    EVENT_HANDLER(SaveResourcesToFiles));
+		m_event_world_load      = SUBSCRIBE_TO_EVENT(Event_World_Load,	    EVENT_HANDLER(LoadResourcesFromFiles));
+		m_event_world_unload    = SUBSCRIBE_TO_EVENT(Event_World_Unload,	EVENT_HANDLER(Clear));
+        m_event_frame_end       = SUBSCRIBE_TO_EVENT(Event_Frame_End,	    EVENT_HANDLER(OnFrameEnd));
 	}
 
 	ResourceCache::~ResourceCache()
 	{
-		// Unsubscribe from event
-		UNSUBSCRIBE_FROM_EVENT(Event_World_Unload, EVENT_HANDLER(Clear));
+		// Unsubscribe from events
+		UNSUBSCRIBE_FROM_EVENT(m_event_world_save);
+		UNSUBSCRIBE_FROM_EVENT(m_event_world_load);
+		UNSUBSCRIBE_FROM_EVENT(m_event_world_unload);
+		UNSUBSCRIBE_FROM_EVENT(m_event_frame_end);
+		SetHotReload(false);
 		Clear();
 	}
 
 	bool ResourceCache::Initialize()
 	{
 		// Importers
+		m_import_cache      = make_shared<ImportCache>(m_context);
 		m_importer_image	= make_shared<ImageImporter>(m_context);
 		m_importer_model	= make_shared<ModelImporter>(m_context);
 		m_importer_font		= make_shared<FontImporter>(m_context);
+
+        // Mount the project's archives, loose files still override them
+        for (const string& file_path : FileSystem::GetFilesInDirectory(m_project_directory))
+        {
+            if (FileSystem::GetExtensionFromFilePath(file_path) == EXTENSION_ARCHIVE)
+            {
+                FileSystem::MountArchive(file_path);
+            }
+        }
+
 		return true;
 	}
 
@@ -87,52 +109,528 @@ namespace Spartan
 			return false;
 		}
 
-		for (const auto& resource : m_resource_groups[resource_type])
-		{
-			if (resource_name == resource->GetResourceName())
-				return true;
-		}
-
-		return false;
+        shared_lock<shared_mutex> lock(m_mutex);
+        const ResourceGroup& group = m_resource_groups[resource_type];
+        return group.index_name.find(resource_name) != group.index_name.end();
 	}
 
-	shared_ptr<IResource>& ResourceCache::GetByName(const string& name, const Resource_Type type)
+	shared_ptr<IResource> ResourceCache::GetByName(const string& name, const Resource_Type type)
 	{
-		for (auto& resource : m_resource_groups[type])
-		{
-			if (name == resource->GetResourceName())
-				return resource;
-		}
+        string file_path;
+        {
+            shared_lock<shared_mutex> lock(m_mutex);
+            const ResourceGroup& group = m_resource_groups[type];
 
-        static shared_ptr<IResource> empty;
-		return empty;
+            auto it = group.index_name.find(name);
+            if (it != group.index_name.end())
+            {
+                group.resources[it->second]->MarkUsed();
+                return group.resources[it->second];
+            }
+
+            auto it_evicted = group.evicted_names.find(name);
+            if (it_evicted == group.evicted_names.end())
+                return nullptr;
+
+            file_path = it_evicted->second;
+        }
+
+        return Reload(file_path, type);
 	}
 
+    shared_ptr<IResource> ResourceCache::GetByPath(const string& path, const Resource_Type type)
+    {
+        {
+            shared_lock<shared_mutex> lock(m_mutex);
+            const ResourceGroup& group = m_resource_groups[type];
+
+            auto it = group.index_path.find(path);
+            if (it != group.index_path.end())
+            {
+                group.resources[it->second]->MarkUsed();
+                return group.resources[it->second];
+            }
+
+            if (group.evicted_paths.find(path) == group.evicted_paths.end())
+                return nullptr;
+        }
+
+        return Reload(path, type);
+    }
+
+    shared_ptr<IResource> ResourceCache::GetById(const uint32_t id, const Resource_Type type)
+    {
+        shared_lock<shared_mutex> lock(m_mutex);
+        const ResourceGroup& group = m_resource_groups[type];
+        auto it = group.index_id.find(id);
+        return it != group.index_id.end() ? group.resources[it->second] : nullptr;
+    }
+
 	vector<shared_ptr<IResource>> ResourceCache::GetByType(const Resource_Type type /*= Resource_Unknown*/)
 	{
+        shared_lock<shared_mutex> lock(m_mutex);
+
 		vector<shared_ptr<IResource>> resources;
 
 		if (type == Resource_Unknown)
 		{
-			for (const auto& resource_group : m_resource_groups)
+			for (const ResourceGroup& group : m_resource_groups)
 			{
-				resources.insert(resources.end(), resource_group.second.begin(), resource_group.second.end());
+				resources.insert(resources.end(), group.resources.begin(), group.resources.end());
 			}
 		}
 		else
 		{
-			resources = m_resource_groups[type];
+			resources = m_resource_groups[type].resources;
 		}
 
 		return resources;
 	}
 
+    shared_ptr<IResource> ResourceCache::CacheResource(const shared_ptr<IResource>& resource, bool* added)
+    {
+        unique_lock<shared_mutex> lock(m_mutex);
+        ResourceGroup& group = m_resource_groups[resource->GetResourceType()];
+
+        // The name is what identifies a resource
+        auto it = group.index_name.find(resource->GetResourceName());
+        if (it != group.index_name.end())
+        {
+            *added = false;
+            return group.resources[it->second];
+        }
+
+        const uint32_t index = static_cast<uint32_t>(group.resources.size());
+        group.resources.emplace_back(resource);
+        group.names.emplace_back(resource->GetResourceName());
+        group.paths.emplace_back(resource->GetResourceFilePathNative());
+        group.ids.emplace_back(resource->GetId());
+        group.index_name[group.names.back()]    = index;
+        group.index_path[group.paths.back()]    = index;
+        group.index_id[group.ids.back()]        = index;
+        group.evicted_names.erase(group.names.back());
+        group.evicted_paths.erase(group.paths.back());
+        resource->MarkUsed();
+
+        *added = true;
+        return resource;
+    }
+
+    void ResourceCache::RemoveResource(const uint32_t id, const Resource_Type type)
+    {
+        shared_ptr<IResource> resource;
+        {
+            unique_lock<shared_mutex> lock(m_mutex);
+            ResourceGroup& group = m_resource_groups[type];
+
+            auto it = group.index_id.find(id);
+            if (it == group.index_id.end())
+                return;
+
+            resource = RemoveAt(group, it->second);
+        }
+    }
+
+    shared_ptr<IResource> ResourceCache::RemoveAt(ResourceGroup& group, const uint32_t index)
+    {
+        shared_ptr<IResource> resource = move(group.resources[index]);
+        group.index_name.erase(group.names[index]);
+        group.index_path.erase(group.paths[index]);
+        group.index_id.erase(group.ids[index]);
+
+        // Move the last resource into the hole, so that only its index entries have to change
+        const uint32_t index_last = static_cast<uint32_t>(group.resources.size() - 1);
+        if (index != index_last)
+        {
+            group.resources[index]  = move(group.resources[index_last]);
+            group.names[index]      = move(group.names[index_last]);
+            group.paths[index]      = move(group.paths[index_last]);
+            group.ids[index]        = group.ids[index_last];
+            group.index_name[group.names[index]]    = index;
+            group.index_path[group.paths[index]]    = index;
+            group.index_id[group.ids[index]]        = index;
+        }
+
+        group.resources.pop_back();
+        group.names.pop_back();
+        group.paths.pop_back();
+        group.ids.pop_back();
+
+        // Returned so that the caller can release it after unlocking
+        return resource;
+    }
+
+    shared_ptr<IResource> ResourceCache::CreateResource(const Resource_Type type)
+    {
+        switch (type)
+        {
+        case Resource_Model:        return make_shared<Model>(m_context);
+        case Resource_Material:     return make_shared<Material>(m_context);
+        case Resource_Texture:      return make_shared<RHI_Texture>(m_context);
+        case Resource_Texture2d:    return make_shared<RHI_Texture2D>(m_context);
+        case Resource_TextureCube:  return make_shared<RHI_TextureCube>(m_context);
+        case Resource_Audio:        return make_shared<AudioClip>(m_context);
+        default:                    return nullptr;
+        }
+    }
+
+    shared_ptr<IResource> ResourceCache::Reload(const string& file_path, const Resource_Type type)
+    {
+        // Register the reload like an asynchronous load, so concurrent requests for the same resource share it
+        const string name   = FileSystem::GetFileNameNoExtensionFromFilePath(file_path);
+        bool registered     = false;
+        shared_ptr<ResourceLoad> load = LoadAsyncRegister(type, name, [this, type, &file_path]()
+        {
+            // Only the types which can be deserialized from their native file get evicted
+            shared_ptr<IResource> resource = CreateResource(type);
+            if (resource)
+            {
+                resource->SetResourceFilePath(file_path);
+            }
+            return resource;
+        }, &registered);
+
+        if (registered)
+        {
+            shared_ptr<IResource> resource = load->resource;
+            if (!resource)
+            {
+                lock_guard<shared_mutex> lock(m_mutex);
+                m_resource_groups[type].loads.erase(name);
+                load->stage.store(2, memory_order_release);
+                return nullptr;
+            }
+
+            // Loaded as a task, so that anyone else who requests it meanwhile can help instead of spinning
+            const TaskHandle task = m_context->GetSubsystem<Threading>()->AddTask([this, load, resource, file_path]()
+            {
+                load->stage.store(1, memory_order_release);
+                if (resource->LoadFromFile(file_path))
+                {
+                    // The native file is what it was loaded from, so there is nothing to save
+                    bool added = false;
+                    shared_ptr<IResource> cached = CacheResource(resource, &added);
+                    if (cached && cached != resource)
+                    {
+                        atomic_store(&load->resource, cached);
+                    }
+                }
+                else
+                {
+                    LOG_ERROR("Failed to reload \"%s\".", file_path.c_str());
+                    resource->SetLoadState(LoadState_Failed);
+                }
+
+                LoadAsyncFinish(load);
+            });
+            LoadSetTask(load, task);
+        }
+
+        LoadWait(load);
+
+        shared_ptr<IResource> resource = atomic_load(&load->resource);
+        return (resource && resource->GetLoadState() != LoadState_Failed) ? resource : nullptr;
+    }
+
+    void ResourceCache::SetMemoryBudget(const Resource_Type type, const uint64_t budget_cpu, const uint64_t budget_gpu)
+    {
+        if (type == Resource_Unknown)
+        {
+            LOG_ERROR_INVALID_PARAMETER();
+            return;
+        }
+
+        m_budget_cpu[type] = budget_cpu;
+        m_budget_gpu[type] = budget_gpu;
+    }
+
+    void ResourceCache::Evict()
+    {
+        const uint64_t frame = IResource::GetFrame();
+        IResource::AdvanceFrame();
+
+        vector<shared_ptr<IResource>> evicted;
+        for (uint32_t type = Resource_Unknown + 1; type < static_cast<uint32_t>(m_resource_groups.size()); type++)
+        {
+            if (m_budget_cpu[type] == 0 && m_budget_gpu[type] == 0)
+                continue;
+
+            unique_lock<shared_mutex> lock(m_mutex);
+            ResourceGroup& group = m_resource_groups[type];
+
+            // Measure usage and collect the resources that only the cache references and that haven't been used for a while
+            uint64_t usage_cpu = 0;
+            uint64_t usage_gpu = 0;
+            vector<uint32_t> candidates;
+            for (uint32_t i = 0; i < static_cast<uint32_t>(group.resources.size()); i++)
+            {
+                const shared_ptr<IResource>& resource = group.resources[i];
+                usage_cpu += resource->GetSizeCpu();
+                usage_gpu += resource->GetSizeGpu();
+
+                if (resource.use_count() == 1 && resource->GetLoadState() == LoadState_Completed && resource->GetFrameUsed() + m_eviction_frames_unused <= frame)
+                {
+                    candidates.emplace_back(i);
+                }
+            }
+
+            const auto over_budget = [this, type, &usage_cpu, &usage_gpu]()
+            {
+                return (m_budget_cpu[type] != 0 && usage_cpu > m_budget_cpu[type]) || (m_budget_gpu[type] != 0 && usage_gpu > m_budget_gpu[type]);
+            };
+
+            if (!over_budget() || candidates.empty())
+                continue;
+
+            // Least recently used first, removal happens from the highest index down so that the swaps don't move any candidate
+            sort(candidates.begin(), candidates.end(), [&group](const uint32_t a, const uint32_t b) { return group.resources[a]->GetFrameUsed() < group.resources[b]->GetFrameUsed(); });
+            size_t count = 0;
+            for (; count < candidates.size() && over_budget(); count++)
+            {
+                const IResource* resource = group.resources[candidates[count]].get();
+                usage_cpu -= min(usage_cpu, resource->GetSizeCpu());
+                usage_gpu -= min(usage_gpu, resource->GetSizeGpu());
+            }
+            candidates.resize(count);
+            sort(candidates.begin(), candidates.end(), greater<uint32_t>());
+
+            for (const uint32_t index : candidates)
+            {
+                // Only reload what can be found on disk
+                if (!FileSystem::IsFile(group.paths[index]))
+                    continue;
+
+                group.evicted_names[group.names[index]] = group.paths[index];
+                group.evicted_paths.insert(group.paths[index]);
+                evicted.emplace_back(RemoveAt(group, index));
+            }
+        }
+
+        if (!evicted.empty())
+        {
+            LOG_INFO("Evicted %d resources", static_cast<int>(evicted.size()));
+        }
+    }
+
+    shared_ptr<ResourceLoad> ResourceCache::LoadAsyncRegister(const Resource_Type type, const string& name, const function<shared_ptr<IResource>()>& create, bool* registered)
+    {
+        unique_lock<shared_mutex> lock(m_mutex);
+        ResourceGroup& group = m_resource_groups[type];
+        *registered = false;
+
+        // Already cached
+        auto it_cached = group.index_name.find(name);
+        if (it_cached != group.index_name.end())
+        {
+            auto load       = make_shared<ResourceLoad>();
+            load->resource  = group.resources[it_cached->second];
+            load->stage     = 2;
+            group.resources[it_cached->second]->MarkUsed();
+            return load;
+        }
+
+        // Already loading
+        auto it_load = group.loads.find(name);
+        if (it_load != group.loads.end())
+            return it_load->second;
+
+        // Only now is the resource constructed
+        auto load       = make_shared<ResourceLoad>();
+        load->resource  = create();
+        group.loads[name] = load;
+        *registered     = true;
+
+        return load;
+    }
+
+    void ResourceCache::LoadAsyncFinish(const shared_ptr<ResourceLoad>& load)
+    {
+        {
+            unique_lock<shared_mutex> lock(m_mutex);
+            const shared_ptr<IResource> resource = atomic_load(&load->resource);
+            m_resource_groups[resource->GetResourceType()].loads.erase(resource->GetResourceName());
+        }
+
+        load->stage.store(2, memory_order_release);
+    }
+
+    void ResourceCache::LoadSetTask(const shared_ptr<ResourceLoad>& load, const TaskHandle& task)
+    {
+        unique_lock<shared_mutex> lock(m_mutex);
+        load->task = task;
+    }
+
+    void ResourceCache::LoadWait(const shared_ptr<ResourceLoad>& load)
+    {
+        // Waiting on the task helps run it (and whatever else is queued), even from a background task
+        Threading* threading = m_context->GetSubsystem<Threading>();
+        while (load->stage.load(memory_order_acquire) != 2)
+        {
+            TaskHandle task;
+            {
+                shared_lock<shared_mutex> lock(m_mutex);
+                task = load->task;
+            }
+
+            if (task.IsValid())
+            {
+                threading->Wait(task);
+            }
+            else if (!threading->TaskExecuteNext(Task_Background)) // the task is about to be set
+            {
+                this_thread::yield();
+            }
+        }
+    }
+
+    void ResourceCache::SetHotReload(const bool enabled)
+    {
+        if (m_hot_reload == enabled)
+            return;
+
+        m_hot_reload = enabled;
+        if (enabled)
+        {
+            FileSystem::WatchDirectory(FileSystem::GetWorkingDirectory());
+        }
+        else
+        {
+            FileSystem::UnwatchDirectories();
+        }
+    }
+
+    void ResourceCache::OnFrameEnd()
+    {
+        HotReload();
+        Evict();
+    }
+
+    void ResourceCache::HotReload()
+    {
+        if (!m_hot_reload)
+            return;
+
+        // Swap in the re-imports which finished
+        vector<pair<shared_ptr<IResource>, shared_ptr<IResource>>> swaps;
+        {
+            lock_guard<mutex> lock(m_hot_reload_mutex);
+            swaps.swap(m_hot_reload_swaps);
+        }
+        for (const auto& swap : swaps)
+        {
+            HotReloadSwap(swap.first, swap.second);
+        }
+
+        const vector<string> changed_files = FileSystem::GetChangedFiles();
+        if (changed_files.empty())
+            return;
+
+        // Native files are written by the engine itself, so only source images are followed
+        unordered_set<string> changed_sources;
+        for (const string& file_path : changed_files)
+        {
+            if (FileSystem::IsSupportedImageFile(file_path))
+            {
+                changed_sources.insert(Archive::NormalizePath(file_path));
+            }
+        }
+        if (changed_sources.empty())
+            return;
+
+        Threading* threading = m_context->GetSubsystem<Threading>();
+        for (const Resource_Type type : { Resource_Texture2d, Resource_TextureCube })
+        {
+            for (const shared_ptr<IResource>& resource : GetByType(type))
+            {
+                const string& source = resource->GetResourceFilePath();
+                if (source.empty() || changed_sources.find(Archive::NormalizePath(source)) == changed_sources.end())
+                    continue;
+
+                // Already being re-imported
+                {
+                    lock_guard<mutex> lock(m_hot_reload_mutex);
+                    if (!m_hot_reload_loading.insert(resource->GetResourceName()).second)
+                        continue;
+                }
+
+                // Re-import in the background with the same settings
+                const bool generate_mipmaps = static_pointer_cast<RHI_Texture>(resource)->GetFlags() & RHI_Texture_GenerateMipsWhenLoading;
+                const shared_ptr<IResource> resource_new = type == Resource_Texture2d ? static_pointer_cast<IResource>(make_shared<RHI_Texture2D>(m_context, generate_mipmaps)) : CreateResource(type);
+                threading->AddTask([this, resource, resource_new, source]()
+                {
+                    if (resource_new->LoadFromFile(source))
+                    {
+                        LOG_INFO("Re-imported \"%s\"", source.c_str());
+                        resource_new->SaveToFile(resource_new->GetResourceFilePathNative());
+
+                        lock_guard<mutex> lock(m_hot_reload_mutex);
+                        m_hot_reload_swaps.emplace_back(resource, resource_new);
+                    }
+                    else
+                    {
+                        lock_guard<mutex> lock(m_hot_reload_mutex);
+                        m_hot_reload_loading.erase(resource->GetResourceName());
+                    }
+                }, Task_Background);
+            }
+        }
+    }
+
+    void ResourceCache::HotReloadSwap(const shared_ptr<IResource>& resource_old, const shared_ptr<IResource>& resource_new)
+    {
+        {
+            lock_guard<mutex> lock(m_hot_reload_mutex);
+            m_hot_reload_loading.erase(resource_old->GetResourceName());
+        }
+
+        // Take the old resource's place in the cache, unless it's not cached anymore
+        {
+            unique_lock<shared_mutex> lock(m_mutex);
+            ResourceGroup& group = m_resource_groups[resource_old->GetResourceType()];
+
+            auto it = group.index_id.find(resource_old->GetId());
+            if (it == group.index_id.end())
+                return;
+
+            const uint32_t index = it->second;
+            group.index_id.erase(it);
+            group.resources[index]              = resource_new;
+            group.ids[index]                    = resource_new->GetId();
+            group.index_id[group.ids[index]]    = index;
+        }
+
+        // Update the materials which use it
+        const shared_ptr<RHI_Texture> texture_old = static_pointer_cast<RHI_Texture>(resource_old);
+        const shared_ptr<RHI_Texture> texture_new = static_pointer_cast<RHI_Texture>(resource_new);
+        for (const shared_ptr<IResource>& resource : GetByType(Resource_Material))
+        {
+            Material* material = static_cast<Material*>(resource.get());
+            for (const Material_Property slot : { Material_Color, Material_Roughness, Material_Metallic, Material_Normal, Material_Height, Material_Occlusion, Material_Emission, Material_Mask })
+            {
+                if (material->HasTexture(slot) && material->GetTexture_PtrShared(slot) == texture_old)
+                {
+                    material->SetTextureSlot(slot, texture_new, material->GetProperty(slot));
+                }
+            }
+        }
+    }
+
+    void ResourceCache::Clear()
+    {
+        unique_lock<shared_mutex> lock(m_mutex);
+
+        for (ResourceGroup& group : m_resource_groups)
+        {
+            group = ResourceGroup();
+        }
+    }
+
 	void ResourceCache::SaveResourcesToFiles()
 	{
 		// Start progress report
 		ProgressReport::Get().Reset(g_progress_resource_cache);
 		ProgressReport::Get().SetIsLoading(g_progress_resource_cache, true);
-		ProgressReport::Get().SetStatus(g_progress_resource_cache, "Loading resources...");
+		ProgressReport::Get().SetStatus(g_progress_resource_cache, "Saving resources...");
 
 		// Create resource list file
 		string file_path = GetProjectDirectoryAbsolute() + m_context->GetSubsystem<World>()->GetName() + "_resources.dat";
@@ -143,31 +641,30 @@ namespace Spartan
 			return;
 		}
 
-        const auto resource_count = GetResourceCount();
+        // Only resources with a native file can be saved (and loaded back)
+        vector<shared_ptr<IResource>> resources = GetByType();
+        resources.erase(remove_if(resources.begin(), resources.end(), [](const shared_ptr<IResource>& resource) { return !resource->HasFilePathNative(); }), resources.end());
+        const auto resource_count = static_cast<uint32_t>(resources.size());
 		ProgressReport::Get().SetJobCount(g_progress_resource_cache, resource_count);
 
-		// Save resource count
+		// Save resource count, file paths and types
 		file->Write(resource_count);
-
-		// Save all the currently used resources to disk
-		for (const auto& resource_group : m_resource_groups)
+		for (const auto& resource : resources)
 		{
-			for (const auto& resource : resource_group.second)
-			{
-				if (!resource->HasFilePathNative())
-					continue;
-
-				// Save file path
-				file->Write(resource->GetResourceFilePathNative());
-				// Save type
-				file->Write(static_cast<uint32_t>(resource->GetResourceType()));
-				// Save resource (to a dedicated file)
-				resource->SaveToFile(resource->GetResourceFilePathNative());
-
-				// Update progress
-				ProgressReport::Get().IncrementJobsDone(g_progress_resource_cache);
-			}
+			file->Write(resource->GetResourceFilePathNative());
+			file->Write(static_cast<uint32_t>(resource->GetResourceType()));
 		}
+        file->Close();
+
+		// Save all the currently used resources to disk (to dedicated files), every resource writes its own file so they can all be saved in parallel
+        m_context->GetSubsystem<Threading>()->AddTaskLoop([&resources](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                resources[i]->SaveToFile(resources[i]->GetResourceFilePathNative());
+                ProgressReport::Get().IncrementJobsDone(g_progress_resource_cache);
+            }
+        }, resource_count, 1);
 
 		// Finish with progress report
 		ProgressReport::Get().SetIsLoading(g_progress_resource_cache, false);
@@ -181,67 +678,145 @@ namespace Spartan
 		if (!file->IsOpen())
 			return;
 		
-		// Load resource count
+		// Load resource count, file paths and types
         const auto resource_count = file->ReadAs<uint32_t>();
-
-		for (uint32_t i = 0; i < resource_count; i++)
+        vector<pair<string, Resource_Type>> entries(resource_count);
+		for (auto& entry : entries)
 		{
-			// Load resource file path
-			auto file_path = file->ReadAs<string>();
-
-			// Load resource type
-            const auto type = static_cast<Resource_Type>(file->ReadAs<uint32_t>());
-
-			switch (type)
-			{
-			case Resource_Model:
-				Load<Model>(file_path);
-				break;
-			case Resource_Material:
-				Load<Material>(file_path);
-				break;
-			case Resource_Texture:
-				Load<RHI_Texture>(file_path);
-				break;
-			case Resource_Texture2d:
-				Load<RHI_Texture2D>(file_path);
-				break;
-			case Resource_TextureCube:
-				Load<RHI_TextureCube>(file_path);
-				break;
-            case Resource_Audio:
-                Load<AudioClip>(file_path);
-                break;
-			}
+            entry.first     = file->ReadAs<string>();
+            entry.second    = static_cast<Resource_Type>(file->ReadAs<uint32_t>());
 		}
-	}
+        file->Close();
 
-    uint64_t ResourceCache::GetMemoryUsageCpu(Resource_Type type /*= Resource_Unknown*/)
-    {
-        uint64_t size = 0;
+		// Start progress report
+		ProgressReport::Get().Reset(g_progress_resource_cache);
+		ProgressReport::Get().SetIsLoading(g_progress_resource_cache, true);
+		ProgressReport::Get().SetStatus(g_progress_resource_cache, "Loading resources...");
+		ProgressReport::Get().SetJobCount(g_progress_resource_cache, resource_count);
 
-        if (type == Resource_Unknown)
+        // Resources are loaded in parallel, one type group at a time, so that whatever a resource
+        // refers to is already cached when it loads (materials refer to textures, models to materials)
+        const vector<vector<Resource_Type>> stages =
+        {
+            { Resource_Texture, Resource_Texture2d, Resource_TextureCube, Resource_Audio },
+            { Resource_Material },
+            { Resource_Model }
+        };
+
+        Threading* threading = m_context->GetSubsystem<Threading>();
+        vector<const pair<string, Resource_Type>*> stage_entries;
+        for (const vector<Resource_Type>& stage : stages)
         {
-            for (const auto& group : m_resource_groups)
+            stage_entries.clear();
+            for (const auto& entry : entries)
             {
-                for (const auto& resource : group.second)
+                if (find(stage.begin(), stage.end(), entry.second) != stage.end())
                 {
-                    if (Spartan_Object* object = dynamic_cast<Spartan_Object*>(resource.get()))
+                    stage_entries.emplace_back(&entry);
+                }
+            }
+
+            threading->AddTaskLoop([this, &stage_entries](const uint32_t start, const uint32_t end)
+            {
+                for (uint32_t i = start; i < end; i++)
+                {
+                    const string& file_path = stage_entries[i]->first;
+
+                    switch (stage_entries[i]->second)
                     {
-                        size += object->GetSizeCpu();
+                    case Resource_Model:
+                        Load<Model>(file_path);
+                        break;
+                    case Resource_Material:
+                        Load<Material>(file_path);
+                        break;
+                    case Resource_Texture:
+                        Load<RHI_Texture>(file_path);
+                        break;
+                    case Resource_Texture2d:
+                        Load<RHI_Texture2D>(file_path);
+                        break;
+                    case Resource_TextureCube:
+                        Load<RHI_TextureCube>(file_path);
+                        break;
+                    case Resource_Audio:
+                        Load<AudioClip>(file_path);
+                        break;
                     }
+
+                    ProgressReport::Get().IncrementJobsDone(g_progress_resource_cache);
                 }
-            }
+            }, static_cast<uint32_t>(stage_entries.size()), 1);
         }
-        else
+
+        // Types which have no loader here (fonts, shaders, ...) are skipped but still count as done
+        ProgressReport::Get().SetJobsDone(g_progress_resource_cache, resource_count);
+		ProgressReport::Get().SetIsLoading(g_progress_resource_cache, false);
+	}
+
+    bool ResourceCache::PackProject(const string& name, const uint64_t max_archive_size /*= 0*/)
+    {
+        // Gather the engine files and the world resource lists, the import cache and existing archives stay out
+        vector<string> file_paths;
+        vector<string> directories = { m_project_directory };
+        while (!directories.empty())
         {
-            for (const auto& resource : m_resource_groups[type])
+            const string directory = directories.back();
+            directories.pop_back();
+
+            for (const string& file_path : FileSystem::GetFilesInDirectory(directory))
             {
-                if (Spartan_Object* object = dynamic_cast<Spartan_Object*>(resource.get()))
+                if (FileSystem::IsEngineFile(file_path) || FileSystem::GetExtensionFromFilePath(file_path) == ".dat")
                 {
-                    size += object->GetSizeCpu();
+                    file_paths.emplace_back(file_path);
                 }
             }
+
+            for (const string& sub_directory : FileSystem::GetDirectoriesInDirectory(directory))
+            {
+                if (FileSystem::GetFileNameFromFilePath(sub_directory) != "Cache")
+                {
+                    directories.emplace_back(sub_directory);
+                }
+            }
+        }
+
+        // Split into archives which don't exceed the maximum size
+        vector<vector<string>> archives(1);
+        uint64_t archive_size = 0;
+        for (const string& file_path : file_paths)
+        {
+            const uint64_t file_size = FileSystem::GetFileSize(file_path);
+            if (max_archive_size != 0 && archive_size != 0 && archive_size + file_size > max_archive_size)
+            {
+                archives.emplace_back();
+                archive_size = 0;
+            }
+
+            archives.back().emplace_back(file_path);
+            archive_size += file_size;
+        }
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(archives.size()); i++)
+        {
+            const string archive_path = m_project_directory + name + (archives.size() == 1 ? "" : "_" + to_string(i)) + EXTENSION_ARCHIVE;
+            if (!Archive::Pack(archives[i], archive_path))
+                return false;
+        }
+
+        return true;
+    }
+
+    uint64_t ResourceCache::GetMemoryUsageCpu(Resource_Type type /*= Resource_Unknown*/)
+    {
+        uint64_t size = 0;
+
+        for (const auto& resource : GetByType(type))
+        {
+            if (Spartan_Object* object = dynamic_cast<Spartan_Object*>(resource.get()))
+            {
+                size += object->GetSizeCpu();
+            }
         }
 
         return size;
@@ -251,7 +826,7 @@ namespace Spartan
     {
         uint64_t size = 0;
 
-        for (const auto& resource : m_resource_groups[type])
+        for (const auto& resource : GetByType(type))
         {
             if (Spartan_Object* object = dynamic_cast<Spartan_Object*>(resource.get()))
             {
@@ -264,7 +839,18 @@ namespace Spartan
 
     uint32_t ResourceCache::GetResourceCount(const Resource_Type type)
 	{
-		return static_cast<uint32_t>(GetByType(type).size());
+        shared_lock<shared_mutex> lock(m_mutex);
+
+        if (type != Resource_Unknown)
+            return static_cast<uint32_t>(m_resource_groups[type].resources.size());
+
+        uint32_t count = 0;
+        for (const ResourceGroup& group : m_resource_groups)
+        {
+            count += static_cast<uint32_t>(group.resources.size());
+        }
+
+		return count;
 	}
 
 	void ResourceCache::AddDataDirectory(const Asset_Type type, const string& directory)
@@ -23,8 +23,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include <unordered_map>
+#include <unordered_set>
+#include <shared_mutex>
+#include <array>
+#include <functional>
 #include "IResource.h"
 #include "../Core/ISubsystem.h"
+#include "../Core/EventSystem.h"
+#include "../Threading/Threading.h"
 //=============================
 
 namespace Spartan
@@ -33,6 +39,7 @@ namespace Spartan
     class FontImporter;
     class ImageImporter;
     class ModelImporter;
+    class ImportCache;
 
 	enum Asset_Type
 	{
@@ -45,6 +52,33 @@ namespace Spartan
 		Asset_Textures
 	};
 
+    // The state of an asynchronous load, shared by everyone who requested the same resource
+    struct ResourceLoad
+    {
+        std::shared_ptr<IResource> resource; // swapped atomically if another load cached the same resource first
+        std::atomic<uint8_t> stage = 0; // queued, loading, done
+        TaskHandle task; // the task doing the load, so waiting on it can help run it (guarded by the cache's mutex)
+    };
+
+    // Returned by ResourceCache::LoadAsync(), the resource can be used right away and it's safe to render with,
+    // everything that binds it sees a placeholder until its load state becomes completed.
+    template <class T>
+    class ResourceHandle
+    {
+    public:
+        ResourceHandle() = default;
+        ResourceHandle(const std::shared_ptr<ResourceLoad>& load) { m_load = load; }
+
+        std::shared_ptr<T> Get()    const { return m_load ? std::static_pointer_cast<T>(std::atomic_load(&m_load->resource)) : nullptr; }
+        bool IsValid()              const { return m_load != nullptr; }
+        bool IsDone()               const { return !m_load || m_load->stage.load(std::memory_order_acquire) == 2; }
+        bool IsLoaded()             const { return m_load && std::atomic_load(&m_load->resource)->GetLoadState() == LoadState_Completed; }
+        float GetProgress()         const { return m_load ? static_cast<float>(m_load->stage.load(std::memory_order_acquire)) * 0.5f : 1.0f; }
+
+    private:
+        std::shared_ptr<ResourceLoad> m_load;
+    };
+
 	class SPARTAN_CLASS ResourceCache : public ISubsystem
 	{
 	public:
@@ -56,7 +90,7 @@ namespace Spartan
 		//=========================
 
         // Get by name
-		std::shared_ptr<IResource>& GetByName(const std::string& name, Resource_Type type);
+		std::shared_ptr<IResource> GetByName(const std::string& name, Resource_Type type);
 		template <class T> 
 		constexpr std::shared_ptr<T> GetByName(const std::string& name) 
 		{ 
@@ -66,19 +100,22 @@ namespace Spartan
 		// Get by type
 		std::vector<std::shared_ptr<IResource>> GetByType(Resource_Type type = Resource_Unknown);
 
-		// Get by path
+		// Get by (native) path
+        std::shared_ptr<IResource> GetByPath(const std::string& path, Resource_Type type);
 		template <class T>
 		std::shared_ptr<T> GetByPath(const std::string& path)
 		{
-			for (auto& resource : m_resource_groups[IResource::TypeToEnum<T>()])
-			{
-				if (path == resource->GetResourceFilePathNative())
-					return std::static_pointer_cast<T>(resource);
-			}
-
-            return nullptr;
+            return std::static_pointer_cast<T>(GetByPath(path, IResource::TypeToEnum<T>()));
 		}
 
+        // Get by id
+        std::shared_ptr<IResource> GetById(uint32_t id, Resource_Type type);
+        template <class T>
+        std::shared_ptr<T> GetById(const uint32_t id)
+        {
+            return std::static_pointer_cast<T>(GetById(id, IResource::TypeToEnum<T>()));
+        }
+
 		// Caches resource, or replaces with existing cached resource
 		template <class T>
         [[nodiscard]] std::shared_ptr<T> Cache(const std::shared_ptr<T>& resource)
@@ -101,18 +138,17 @@ namespace Spartan
                 return nullptr;
             }
 
-			// Ensure that this resource is not already cached
-			if (IsCached(resource->GetResourceName(), resource->GetResourceType()))
-				return GetByName<T>(resource->GetResourceName());
-
-            // Prevent threads from colliding in critical section
-            std::lock_guard<mutex> guard(m_mutex);
+			// Cache it, unless a resource with the same name is already cached, in which case that one is returned
+            bool added = false;
+            std::shared_ptr<T> cached = std::static_pointer_cast<T>(CacheResource(resource, &added));
 
             // In order to guarantee deserialization, we save it now
-            resource->SaveToFile(resource->GetResourceFilePathNative());
+            if (added)
+            {
+                resource->SaveToFile(resource->GetResourceFilePathNative());
+            }
 
-			// Cache it
-			return static_pointer_cast<T>(m_resource_groups[resource->GetResourceType()].emplace_back(resource));
+			return cached;
 		}
 		bool IsCached(const std::string& resource_name, Resource_Type resource_type);
 
@@ -122,18 +158,7 @@ namespace Spartan
             if (!resource)
                 return;
 
-            if (!IsCached(resource->GetResourceName(), resource->GetResourceType()))
-                return;
-
-            auto& vector = m_resource_groups[resource->GetResourceType()];
-            for (auto it = vector.begin(); it != vector.end(); it++)
-            {
-                if (dynamic_cast<Spartan_Object*>((*it).get())->GetId() == resource->GetId())
-                {
-                    vector.erase(it);
-                    break;
-                }
-            }
+            RemoveResource(resource->GetId(), resource->GetResourceType());
         }
 
 		// Loads a resource and adds it to the resource cache
@@ -148,8 +173,8 @@ namespace Spartan
 
 			// Check if the resource is already loaded
             const auto name = FileSystem::GetFileNameNoExtensionFromFilePath(file_path);
-			if (IsCached(name, IResource::TypeToEnum<T>()))
-				return GetByName<T>(name);
+			if (std::shared_ptr<T> cached = GetByName<T>(name))
+				return cached;
 
 			// Create new resource
 			auto typed = std::make_shared<T>(m_context);
@@ -157,8 +182,8 @@ namespace Spartan
 			// Set a default file path in case it's not overridden by LoadFromFile()
 			typed->SetResourceFilePath(file_path);
 
-			// Load
-			if (!typed || !typed->LoadFromFile(file_path))
+			// Load, this thread would block on the read anyway, so it reads the file itself instead of queuing behind the I/O threads' reads
+			if (!typed->LoadFromFile(file_path))
 			{
 				LOG_ERROR("Failed to load \"%s\".", file_path.c_str());
 				return nullptr;
@@ -168,17 +193,96 @@ namespace Spartan
 			return Cache<T>(typed);
 		}
 
+        // Returns right away and loads the resource on the thread pool, requests for a resource which
+        // is already cached or already loading share the same resource instead of loading it again.
+        template <class T>
+        ResourceHandle<T> LoadAsync(const std::string& file_path)
+        {
+            if (!FileSystem::Exists(file_path))
+            {
+                LOG_ERROR("\"%s\" doesn't exist.", file_path.c_str());
+                return ResourceHandle<T>();
+            }
+
+            // Share a cached or loading resource, only a new request constructs one (marked as loading before anyone else can see it)
+            bool registered = false;
+            std::shared_ptr<ResourceLoad> load = LoadAsyncRegister(IResource::TypeToEnum<T>(), FileSystem::GetFileNameNoExtensionFromFilePath(file_path), [this, &file_path]()
+            {
+                auto resource = std::make_shared<T>(m_context);
+                resource->SetResourceFilePath(file_path);
+                resource->SetLoadState(LoadState_Started);
+                return std::static_pointer_cast<IResource>(resource);
+            }, &registered);
+            if (!registered)
+                return ResourceHandle<T>(load);
+
+            auto typed = std::static_pointer_cast<T>(load->resource);
+
+            // Publishes the resource, from here on it's used instead of a placeholder
+            auto finish = [this, load, typed, file_path](const bool loaded)
+            {
+                if (loaded)
+                {
+                    // A synchronous load may have cached the same resource in the meantime, everyone gets the cached one
+                    std::shared_ptr<T> cached = Cache<T>(typed);
+                    if (cached && cached != typed)
+                    {
+                        std::atomic_store(&load->resource, std::static_pointer_cast<IResource>(cached));
+                    }
+                }
+                else
+                {
+                    LOG_ERROR("Failed to load \"%s\".", file_path.c_str());
+                    typed->SetLoadState(LoadState_Failed);
+                }
+
+                LoadAsyncFinish(load);
+            };
+
+            // Files which can be parsed from memory are read on the I/O thread, so the workers never wait on the disk
+            Threading* threading = m_context->GetSubsystem<Threading>();
+            TaskHandle task;
+            if (typed->CanLoadFromMemory(file_path))
+            {
+                task = threading->ReadFileAsync(file_path, [load, typed, file_path, finish](std::vector<std::byte>&& data)
+                {
+                    load->stage.store(1, std::memory_order_release);
+                    finish(!data.empty() && typed->LoadFromMemory(file_path, data.data(), data.size()));
+                }, Task_Background);
+            }
+            else
+            {
+                task = threading->AddTask([load, typed, file_path, finish]()
+                {
+                    load->stage.store(1, std::memory_order_release);
+                    finish(typed->LoadFromFile(file_path));
+                }, Task_Background);
+            }
+            LoadSetTask(load, task);
+
+            return ResourceHandle<T>(load);
+        }
+
 		//= I/O ======================
 		void SaveResourcesToFiles();
 		void LoadResourcesFromFiles();
+        // Packs the project's engine files into archives of up to max_archive_size bytes (0 for one archive), they are mounted on startup
+        bool PackProject(const std::string& name, uint64_t max_archive_size = 0);
+        // Watches the working directory and re-imports textures whose source image changed, the materials which use them are updated at the end of a frame
+        void SetHotReload(bool enabled);
 		//============================
 
 		//= MISC ========================================================
 		// Memory
         uint64_t GetMemoryUsageCpu(Resource_Type type = Resource_Unknown);
         uint64_t GetMemoryUsageGpu(Resource_Type type = Resource_Unknown);
+        // Budgets in bytes, 0 means unlimited. Over budget, resources that nothing else references are evicted
+        // (least recently used first) and reloaded from their native file the next time they are requested.
+        void SetMemoryBudget(Resource_Type type, uint64_t budget_cpu, uint64_t budget_gpu);
+        uint64_t GetMemoryBudgetCpu(const Resource_Type type) const { return m_budget_cpu[type]; }
+        uint64_t GetMemoryBudgetGpu(const Resource_Type type) const { return m_budget_gpu[type]; }
 		// Unloads all resources
-		void Clear() { m_resource_groups.clear(); }
+		void Clear();
 		// Returns all resources of a given type
 		uint32_t GetResourceCount(Resource_Type type = Resource_Unknown);
 		//===============================================================
@@ -196,11 +300,52 @@ namespace Spartan
 		auto GetModelImporter() const { return m_importer_model.get(); }
 		auto GetImageImporter() const { return m_importer_image.get(); }
 		auto GetFontImporter()  const { return m_importer_font.get(); }
+        auto GetImportCache()   const { return m_import_cache.get(); }
 
 	private:
-		// Cache
-		std::unordered_map<Resource_Type, std::vector<std::shared_ptr<IResource>>> m_resource_groups;
-		std::mutex m_mutex;
+        // Resources of one type, with hash indexes into them
+        struct ResourceGroup
+        {
+            std::vector<std::shared_ptr<IResource>> resources;
+            std::vector<std::string> names; // the keys the resources were indexed with, in case they get renamed
+            std::vector<std::string> paths;
+            std::vector<uint32_t> ids;
+            std::unordered_map<std::string, uint32_t> index_name;
+            std::unordered_map<std::string, uint32_t> index_path;
+            std::unordered_map<uint32_t, uint32_t> index_id;
+            std::unordered_map<std::string, std::shared_ptr<ResourceLoad>> loads; // asynchronous loads in flight, by name
+            std::unordered_map<std::string, std::string> evicted_names; // evicted resources, name to native file path
+            std::unordered_set<std::string> evicted_paths;
+        };
+
+        std::shared_ptr<IResource> CacheResource(const std::shared_ptr<IResource>& resource, bool* added);
+        void RemoveResource(uint32_t id, Resource_Type type);
+        std::shared_ptr<IResource> RemoveAt(ResourceGroup& group, uint32_t index);
+        std::shared_ptr<IResource> CreateResource(Resource_Type type);
+        std::shared_ptr<IResource> Reload(const std::string& file_path, Resource_Type type);
+        void Evict();
+        void HotReload();
+        void HotReloadSwap(const std::shared_ptr<IResource>& resource_old, const std::shared_ptr<IResource>& resource_new);
+        void OnFrameEnd();
+        std::shared_ptr<ResourceLoad> LoadAsyncRegister(Resource_Type type, const std::string& name, const std::function<std::shared_ptr<IResource>()>& create, bool* registered);
+        void LoadAsyncFinish(const std::shared_ptr<ResourceLoad>& load);
+        void LoadSetTask(const std::shared_ptr<ResourceLoad>& load, const TaskHandle& task);
+        void LoadWait(const std::shared_ptr<ResourceLoad>& load);
+
+		// Cache, reads take a shared lock
+		std::array<ResourceGroup, Resource_Shader + 1> m_resource_groups;
+		std::shared_mutex m_mutex;
+
+        // Memory budgets
+        std::array<uint64_t, Resource_Shader + 1> m_budget_cpu = {};
+        std::array<uint64_t, Resource_Shader + 1> m_budget_gpu = {};
+        const uint64_t m_eviction_frames_unused = 10; // frames in flight may still reference a resource which nothing holds anymore
+
+        // Hot reload, re-imports happen in the background and are swapped in at the end of a frame
+        bool m_hot_reload = false;
+        std::mutex m_hot_reload_mutex;
+        std::vector<std::pair<std::shared_ptr<IResource>, std::shared_ptr<IResource>>> m_hot_reload_swaps;
+        std::unordered_set<std::string> m_hot_reload_loading;
 
 		// Directories
 		std::unordered_map<Asset_Type, std::string> m_standard_resource_directories;
@@ -210,5 +355,12 @@ namespace Spartan
 		std::shared_ptr<ModelImporter> m_importer_model;
 		std::shared_ptr<ImageImporter> m_importer_image;
 		std::shared_ptr<FontImporter> m_importer_font;
+        std::shared_ptr<ImportCache> m_import_cache;
+
+        // Events
+        EventHandle m_event_world_save;
+        EventHandle m_event_world_load;
+        EventHandle m_event_world_unload;
+        EventHandle m_event_frame_end;
 	};
 }
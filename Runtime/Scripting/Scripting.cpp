@@ -34,6 +34,9 @@ namespace Spartan
 {
 	Scripting::Scripting(Context* context) : ISubsystem(context)
 	{
+        // Doesn't tick
+        SetTickDependencies(SubsystemData_None, SubsystemData_None);
+
 		// Subscribe to events
 		SUBSCRIBE_TO_EVENT(Event_World_Unload, EVENT_HANDLER(Clear));
 	}
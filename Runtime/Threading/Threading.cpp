@@ -19,9 +19,14 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+
 //= INCLUDES ================
 #include "Threading.h"
+#include <fstream>
+#include <chrono>
 #include "../Core/Settings.h"
+#include "../Core/FileSystem.h"
+#include "../Core/EventSystem.h"
 //===========================
 
 //= NAMESPACES =====
@@ -30,28 +35,81 @@ using namespace std;
 
 namespace Spartan
 {
-	Threading::Threading(Context* context) : ISubsystem(context)
+    // Index of the calling thread into the per thread data, threads that we don't own get an invalid index
+    static const uint32_t thread_index_external = numeric_limits<uint32_t>::max();
+    static thread_local uint32_t thread_index   = thread_index_external;
+
+    // Priority of the task the calling thread is executing, anything else is the frame itself
+    static thread_local Task_Priority priority_current = Task_Critical;
+
+    // How many tasks move between a thread's free list and the shared pool at once
+    static const uint32_t task_pool_batch_size  = 256;
+
+    // How many threads are reserved for file reads
+    static const uint32_t thread_count_io       = 2;
+
+    static uint64_t time_now_ns()
+    {
+        return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // The continuation lock is only held for a few instructions, so spinning is fine
+    static void task_lock(atomic<bool>& lock)
+    {
+        while (lock.exchange(true, memory_order_acquire))
+        {
+            this_thread::yield();
+        }
+    }
+
+    static void task_unlock(atomic<bool>& lock)
+    {
+        lock.store(false, memory_order_release);
+    }
+
+	Threading::Threading(Context* context, const uint32_t thread_count /*= 0*/) : ISubsystem(context)
 	{
-		m_stopping	                            = false;
-        m_thread_count_support                  = thread::hardware_concurrency();
-		m_thread_count                          = m_thread_count_support - 1; // exclude the main (this) thread
+        // Doesn't tick, still ordered after the timer like the rest of its tick group
+        SetTickDependencies(SubsystemData_Time, SubsystemData_None);
+
+        m_thread_count_support                  = max(thread::hardware_concurrency(), 1u);
+		m_thread_count                          = (thread_count != 0 ? min(thread_count, m_thread_count_support) : m_thread_count_support) - 1; // exclude the main (this) thread
+        m_background_limit                      = max(1u, m_thread_count / 2); // the rest of the workers are always there for the frame
         m_thread_names[this_thread::get_id()]   = "main";
 
+        // Per thread data for the main thread and the workers
+        for (uint32_t i = 0; i < m_thread_count + 1; i++)
+        {
+            m_thread_data.emplace_back(make_unique<ThreadData>());
+        }
+        thread_index = 0;
+
 		for (uint32_t i = 0; i < m_thread_count; i++)
 		{
-			m_threads.emplace_back(thread(&Threading::ThreadLoop, this));
+			m_threads.emplace_back(thread(&Threading::ThreadLoop, this, i + 1));
             m_thread_names[m_threads.back().get_id()] = "worker_" + to_string(i);
 		}
 
+        // The I/O threads spend most of their time waiting on the disk, so they don't count towards the workers
+        for (uint32_t i = 0; i < thread_count_io; i++)
+        {
+            m_threads_io.emplace_back(thread(&Threading::ThreadLoopIo, this));
+            m_thread_names[m_threads_io.back().get_id()] = "io_" + to_string(i);
+        }
+
 		LOG_INFO("%d threads have been created", m_thread_count);
+
+        // Tasks which wait for a frame boundary are released here
+        m_event_frame_end = SUBSCRIBE_TO_EVENT_RAW(Event_Frame_End, EVENT_HANDLER_RAW(Threading, OnFrameEnd), this);
 	}
 
     Threading::~Threading()
     {
+        UNSUBSCRIBE_FROM_EVENT(m_event_frame_end);
         Flush(true);
 
-        // Put unique lock on task mutex.
-        unique_lock<mutex> lock(m_mutex_tasks);
+        // Put unique lock on the sleep mutex.
+        unique_lock<mutex> lock(m_mutex_sleep);
 
         // Set termination flag to true.
         m_stopping = true;
@@ -70,64 +128,539 @@ namespace Spartan
 
         // Empty worker threads.
         m_threads.clear();
+
+        // Stop the I/O threads
+        {
+            lock_guard<mutex> lock_io(m_mutex_io);
+        }
+        m_condition_var_io.notify_all();
+        for (auto& thread : m_threads_io)
+        {
+            thread.join();
+        }
+        m_threads_io.clear();
     }
 
-    uint32_t Threading::GetThreadsAvailable() const
+    void Threading::Wait(const TaskHandle& handle)
     {
-        uint32_t available_threads = m_thread_count;
-
-        for (const auto& task : m_tasks)
+        // Instead of blocking, help with whatever work is queued. A background task which waits on background work
+        // helps with that as well, it already holds a slot, so it can't be starved by the other background tasks.
+        const Task_Priority priority_lowest = priority_current == Task_Background ? Task_Background : Task_Normal;
+        while (!handle.IsDone())
         {
-            available_threads -= task->IsExecuting() ? 1 : 0;
+            if (!TaskExecuteNext(priority_lowest))
+            {
+                this_thread::yield();
+            }
         }
+    }
 
-        return available_threads;
+    uint32_t Threading::GetThreadsAvailable() const
+    {
+        return m_thread_count - m_threads_busy.load(memory_order_relaxed);
+    }
+
+    TaskStats Threading::GetTaskStats(const Task_Priority priority)
+    {
+        PriorityStats& stats_priority = m_task_stats[priority];
+
+        TaskStats stats;
+        stats.queued                = static_cast<uint32_t>(max(stats_priority.queued.load(memory_order_relaxed), 0));
+        stats.executed              = stats_priority.executed.exchange(0, memory_order_relaxed);
+        const uint64_t latency_ns   = stats_priority.latency_ns.exchange(0, memory_order_relaxed);
+        stats.latency_avg_ms        = stats.executed != 0 ? static_cast<float>(latency_ns / stats.executed) / 1000000.0f : 0.0f;
+        stats.latency_max_ms        = static_cast<float>(stats_priority.latency_max_ns.exchange(0, memory_order_relaxed)) / 1000000.0f;
+
+        return stats;
     }
 
     void Threading::Flush(bool removed_queued /*= false*/)
     {
-        // Clear any queued tasks
+        // Tasks waiting for a frame boundary or the disk would never finish while we wait here
+        vector<Task*> tasks_next_frame;
+        {
+            lock_guard<mutex> lock(m_mutex_tasks_next_frame);
+            tasks_next_frame.swap(m_tasks_next_frame);
+        }
+
+        deque<IoRequest> io_requests;
         if (removed_queued)
         {
-            m_tasks.clear();
+            lock_guard<mutex> lock(m_mutex_io);
+            io_requests.swap(m_io_requests);
+        }
+
+        for (Task* task : tasks_next_frame)
+        {
+            removed_queued ? TaskCancel(task) : TaskQueue(task);
         }
 
-        // One task per thread, so we can deduce if anything is running
-        bool tasks_running = GetThreadsAvailable() != GetThreadCount();
+        for (IoRequest& request : io_requests)
+        {
+            TaskCancel(request.task);
+        }
 
-        // If so, wait for them
-        while (tasks_running)
+        // Cancel any queued tasks, finishing them without executing so that anyone waiting on them is released
+        if (removed_queued)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            for (uint32_t priority = 0; priority < priority_count; priority++)
+            {
+                while (Task* task = TaskAcquirePriority(thread_index, static_cast<Task_Priority>(priority)))
+                {
+                    TaskCancel(task);
+                }
+            }
+        }
+
+        // Wait for the rest, helping out if the queued tasks are to be kept
+        while (m_tasks_in_flight.load() != 0)
+        {
+            if (!removed_queued)
+            {
+                if (Task* task = TaskAcquire(thread_index, Task_Normal))
+                {
+                    TaskExecute(task);
+                    continue;
+                }
+            }
+
+            this_thread::yield();
         }
     }
 
-    void Threading::ThreadLoop()
+    void Threading::ThreadLoop(const uint32_t index)
     {
-        shared_ptr<Task> task;
+        thread_index = index;
+
+        // How many times to look for work before going to sleep
+        const uint32_t spin_count   = 64;
+        uint32_t spins              = 0;
+
         while (true)
         {
-            // Lock tasks mutex
-            unique_lock<mutex> lock(m_mutex_tasks);
+            if (Task* task = TaskAcquire(index, Task_Background))
+            {
+                m_threads_busy++;
+                TaskExecute(task);
+                m_threads_busy--;
 
-            // Check condition on notification
-            m_condition_var.wait(lock, [this] { return !m_tasks.empty() || m_stopping; });
+                spins = 0;
+                continue;
+            }
 
-            // If m_stopping is true, it's time to shut everything down
-            if (m_stopping && m_tasks.empty())
+            // If m_stopping is true and there is no work left, it's time to shut everything down
+            if (m_stopping)
                 return;
 
-            // Get next task in the queue.
-            task = m_tasks.front();
+            if (++spins < spin_count)
+            {
+                this_thread::yield();
+                continue;
+            }
+            spins = 0;
 
-            // Remove it from the queue.
-            m_tasks.pop_front();
+            // Sleep until there is work or until it's time to stop
+            unique_lock<mutex> lock(m_mutex_sleep);
+            m_threads_sleeping++;
+            m_condition_var.wait(lock, [this]
+            {
+                const bool background = m_task_stats[Task_Background].queued.load() > 0 && m_background_running.load() < m_background_limit;
+                return m_task_stats[Task_Critical].queued.load() > 0 || m_task_stats[Task_Normal].queued.load() > 0 || background || m_stopping;
+            });
+            m_threads_sleeping--;
+        }
+    }
+
+    void Threading::ThreadLoopIo()
+    {
+        while (true)
+        {
+            // Only file reads happen here, whatever processes the data runs on the workers
+            unique_lock<mutex> lock(m_mutex_io);
+            m_condition_var_io.wait(lock, [this] { return !m_io_requests.empty() || m_stopping; });
+
+            if (m_io_requests.empty())
+                return;
 
-            // Unlock the mutex
+            IoRequest request = move(m_io_requests.front());
+            m_io_requests.pop_front();
             lock.unlock();
 
-            // Execute the task.
-            task->Execute();
+            // Read the whole file, packed files are copied out of their archive
+            const std::byte* archive_data   = nullptr;
+            uint64_t archive_size           = 0;
+            if (FileSystem::FindInArchives(request.file_path, &archive_data, &archive_size))
+            {
+                request.data->assign(archive_data, archive_data + archive_size);
+            }
+            else
+            {
+                ifstream file(request.file_path, ios::binary | ios::ate);
+                if (file.good())
+                {
+                    request.data->resize(static_cast<size_t>(file.tellg()));
+                    file.seekg(0, ios::beg);
+                    if (!file.read(reinterpret_cast<char*>(request.data->data()), request.data->size()))
+                    {
+                        request.data->clear();
+                    }
+                }
+                else
+                {
+                    LOG_ERROR("Failed to open \"%s\" for reading", request.file_path.c_str());
+                }
+            }
+
+            // The data is ready, so let the workers at it
+            TaskQueue(request.task);
+        }
+    }
+
+    void Threading::OnFrameEnd()
+    {
+        vector<Task*> tasks;
+        {
+            lock_guard<mutex> lock(m_mutex_tasks_next_frame);
+            tasks.swap(m_tasks_next_frame);
+        }
+
+        for (Task* task : tasks)
+        {
+            TaskQueue(task);
+        }
+    }
+
+    Task* Threading::TaskAllocate()
+    {
+        ThreadData* thread_data = GetThreadData(thread_index);
+
+        // Threads we don't own go straight to the shared pool
+        if (!thread_data)
+        {
+            lock_guard<mutex> lock(m_mutex_task_pool);
+
+            if (m_tasks_free.empty())
+            {
+                m_task_blocks.emplace_back(make_unique<Task[]>(task_pool_batch_size));
+                for (uint32_t i = 0; i < task_pool_batch_size; i++)
+                {
+                    m_tasks_free.emplace_back(&m_task_blocks.back()[i]);
+                }
+            }
+
+            Task* task = m_tasks_free.back();
+            m_tasks_free.pop_back();
+            return task;
+        }
+
+        // Refill the thread's free list in batches, so the pool lock is rarely taken
+        auto& tasks_free = thread_data->tasks_free;
+        if (tasks_free.empty())
+        {
+            lock_guard<mutex> lock(m_mutex_task_pool);
+
+            if (m_tasks_free.empty())
+            {
+                m_task_blocks.emplace_back(make_unique<Task[]>(task_pool_batch_size));
+                for (uint32_t i = 0; i < task_pool_batch_size; i++)
+                {
+                    tasks_free.emplace_back(&m_task_blocks.back()[i]);
+                }
+            }
+            else
+            {
+                const size_t count = min(m_tasks_free.size(), static_cast<size_t>(task_pool_batch_size));
+                tasks_free.insert(tasks_free.end(), m_tasks_free.end() - count, m_tasks_free.end());
+                m_tasks_free.resize(m_tasks_free.size() - count);
+            }
+        }
+
+        Task* task = tasks_free.back();
+        tasks_free.pop_back();
+        return task;
+    }
+
+    void Threading::TaskFree(Task* task)
+    {
+        ThreadData* thread_data = GetThreadData(thread_index);
+
+        if (!thread_data)
+        {
+            lock_guard<mutex> lock(m_mutex_task_pool);
+            m_tasks_free.emplace_back(task);
+            return;
+        }
+
+        // Tasks are usually allocated by one thread and freed by another, so give back the excess
+        auto& tasks_free = thread_data->tasks_free;
+        tasks_free.emplace_back(task);
+        if (tasks_free.size() >= task_pool_batch_size * 2)
+        {
+            lock_guard<mutex> lock(m_mutex_task_pool);
+            m_tasks_free.insert(m_tasks_free.end(), tasks_free.end() - task_pool_batch_size, tasks_free.end());
+            tasks_free.resize(tasks_free.size() - task_pool_batch_size);
+        }
+    }
+
+    TaskHandle Threading::TaskPrepare(Task* task, const TaskHandle& parent, const Task_Priority priority)
+    {
+        task->m_unfinished.store(1, memory_order_relaxed);
+        task->m_parent          = nullptr;
+        task->m_continuations   = nullptr;
+        task->m_priority        = priority;
+
+        // The parent has to be alive (e.g. this task is added from within the parent), which is what we expect
+        if (parent.IsValid())
+        {
+            if (!parent.IsDone())
+            {
+                parent.m_task->m_unfinished.fetch_add(1, memory_order_relaxed);
+                task->m_parent = parent.m_task;
+            }
+            else
+            {
+                LOG_WARNING("The parent task has already finished, the task will be added without a parent");
+            }
+        }
+
+        m_tasks_in_flight++;
+
+        return TaskHandle(task, task->m_generation.load(memory_order_relaxed));
+    }
+
+    void Threading::TaskQueue(Task* task)
+    {
+        const Task_Priority priority    = task->m_priority;
+        task->m_time_queued             = time_now_ns();
+
+        ThreadData* thread_data = GetThreadData(thread_index);
+        if (thread_data)
+        {
+            m_task_stats[priority].queued++;
+            if (!thread_data->deques[priority].Push(task))
+            {
+                // The deque is full, the most cache friendly thing to do is to execute it right away
+                m_task_stats[priority].queued--;
+                TaskExecute(task);
+                return;
+            }
+        }
+        else
+        {
+            m_task_stats[priority].queued++;
+            lock_guard<mutex> lock(m_mutex_tasks_external);
+            m_tasks_external[priority].emplace_back(task);
+            m_tasks_external_count[priority]++;
+        }
+
+        WakeThread();
+    }
+
+    bool Threading::TaskContinueAfter(Task* task, const TaskHandle& dependency)
+    {
+        if (!dependency.IsValid())
+            return false;
+
+        Task* task_dependency = dependency.m_task;
+        bool added = false;
+
+        // Finishing bumps the generation under the same lock, so either we get in before that or we see it
+        task_lock(task_dependency->m_lock);
+        if (task_dependency->m_generation.load(memory_order_relaxed) == dependency.m_generation && task_dependency->m_unfinished.load(memory_order_acquire) != 0)
+        {
+            task->m_continuation_next           = task_dependency->m_continuations;
+            task_dependency->m_continuations    = task;
+            added                               = true;
+        }
+        task_unlock(task_dependency->m_lock);
+
+        return added;
+    }
+
+    void Threading::TaskCancel(Task* task)
+    {
+        task->FunctionReset();
+        TaskFinish(task);
+    }
+
+    Task* Threading::TaskAcquire(const uint32_t index, const Task_Priority priority_lowest)
+    {
+        for (uint32_t priority = Task_Critical; priority <= priority_lowest && priority < Task_Background; priority++)
+        {
+            if (Task* task = TaskAcquirePriority(index, static_cast<Task_Priority>(priority)))
+                return task;
+        }
+
+        if (priority_lowest != Task_Background)
+            return nullptr;
+
+        // Claim one of the background slots first, so that long running tasks can never occupy all the workers
+        uint32_t running = m_background_running.load();
+        do
+        {
+            if (running >= m_background_limit)
+                return nullptr;
+        } while (!m_background_running.compare_exchange_weak(running, running + 1));
+
+        Task* task = TaskAcquirePriority(index, Task_Background);
+        if (task)
+        {
+            task->m_background_slot = true;
+        }
+        else
+        {
+            BackgroundSlotRelease();
+        }
+
+        return task;
+    }
+
+    Task* Threading::TaskAcquirePriority(const uint32_t index, const Task_Priority priority)
+    {
+        Task* task = nullptr;
+
+        // Own deque first (most recently added, likely still in the cache)
+        if (ThreadData* thread_data = GetThreadData(index))
+        {
+            task = thread_data->deques[priority].Pop();
+        }
+
+        // Then tasks added by threads we don't own
+        if (!task && m_tasks_external_count[priority].load(memory_order_relaxed) != 0)
+        {
+            lock_guard<mutex> lock(m_mutex_tasks_external);
+            if (!m_tasks_external[priority].empty())
+            {
+                task = m_tasks_external[priority].front();
+                m_tasks_external[priority].pop_front();
+                m_tasks_external_count[priority]--;
+            }
+        }
+
+        // Then steal from others (oldest first), starting from our neighbour so that thieves spread out
+        if (!task)
+        {
+            const uint32_t thread_count = static_cast<uint32_t>(m_thread_data.size());
+            const uint32_t start        = index < thread_count ? index + 1 : 0;
+            for (uint32_t i = 0; i < thread_count && !task; i++)
+            {
+                const uint32_t victim = (start + i) % thread_count;
+                if (victim == index)
+                    continue;
+
+                task = m_thread_data[victim]->deques[priority].Steal();
+            }
+        }
+
+        if (task)
+        {
+            PriorityStats& stats    = m_task_stats[priority];
+            const uint64_t latency  = time_now_ns() - task->m_time_queued;
+
+            stats.queued--;
+            stats.executed++;
+            stats.latency_ns += latency;
+
+            uint64_t latency_max = stats.latency_max_ns.load(memory_order_relaxed);
+            while (latency > latency_max && !stats.latency_max_ns.compare_exchange_weak(latency_max, latency, memory_order_relaxed));
+        }
+
+        return task;
+    }
+
+    void Threading::TaskExecute(Task* task)
+    {
+        const Task_Priority priority_previous   = priority_current;
+        priority_current                        = task->m_priority;
+        task->FunctionInvoke();
+        task->FunctionReset(); // release captures before anyone waiting is released
+        priority_current                        = priority_previous;
+
+        if (task->m_background_slot)
+        {
+            task->m_background_slot = false;
+            BackgroundSlotRelease();
+        }
+
+        TaskFinish(task);
+    }
+
+    void Threading::BackgroundSlotRelease()
+    {
+        m_background_running--;
+
+        // Workers which went to sleep because every slot was taken don't wake up for tasks that are already queued
+        if (m_task_stats[Task_Background].queued.load() > 0)
+        {
+            WakeThread();
+        }
+    }
+
+    Task_Priority Threading::GetPriorityCurrent() const
+    {
+        return priority_current;
+    }
+
+    bool Threading::TaskExecuteNext(const Task_Priority priority_lowest /*= Task_Normal*/)
+    {
+        Task* task = TaskAcquire(thread_index, min(priority_lowest, Task_Normal));
+
+        // A thread which is already doing background work doesn't need another slot to help with more of it
+        if (!task && priority_lowest == Task_Background && priority_current == Task_Background)
+        {
+            task = TaskAcquirePriority(thread_index, Task_Background);
+        }
+
+        if (!task)
+            return false;
+
+        TaskExecute(task);
+        return true;
+    }
+
+    void Threading::TaskFinish(Task* task)
+    {
+        // Finishing a task can finish its parent as well, and so on
+        while (task)
+        {
+            if (task->m_unfinished.fetch_sub(1, memory_order_acq_rel) != 1)
+                return;
+
+            Task* parent        = task->m_parent;
+            task->m_parent      = nullptr;
+
+            task_lock(task->m_lock);
+            Task* continuation      = task->m_continuations;
+            task->m_continuations   = nullptr;
+            task->m_generation.fetch_add(1, memory_order_release);
+            task_unlock(task->m_lock);
+
+            TaskFree(task);
+
+            // Queue anything that was waiting on this task, before it stops counting as in flight
+            while (continuation)
+            {
+                Task* next                          = continuation->m_continuation_next;
+                continuation->m_continuation_next   = nullptr;
+                TaskQueue(continuation);
+                continuation                        = next;
+            }
+
+            m_tasks_in_flight--;
+
+            task = parent;
+        }
+    }
+
+    void Threading::WakeThread()
+    {
+        if (m_threads_sleeping.load() == 0)
+            return;
+
+        // Taking the lock guarantees that a thread which is about to sleep will see the new task
+        {
+            lock_guard<mutex> lock(m_mutex_sleep);
         }
+        m_condition_var.notify_one();
     }
 }
@@ -19,119 +19,443 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+
 #pragma once
 
-//= INCLUDES ==================
+//= INCLUDES ===================
 #include <vector>
 #include <thread>
 #include <mutex>
 #include <deque>
+#include <atomic>
+#include <condition_variable>
 #include <unordered_map>
 #include <functional>
+#include <algorithm>
+#include <string>
+#include <cstddef>
+#include <new>
+#include "TaskDeque.h"
 #include "../Logging/Log.h"
 #include "../Core/ISubsystem.h"
-//=============================
+#include "../Core/EventSystem.h"
+//==============================
 
 namespace Spartan
 {
+    // Threads look for work in this order, workers only pick up background tasks while enough of them are left for the rest
+    enum Task_Priority : uint8_t
+    {
+        Task_Critical,      // work the current frame is waiting on
+        Task_Normal,
+        Task_Background     // long running work like imports
+    };
+
+    // Per priority stats, accumulated since the previous call to Threading::GetTaskStats()
+    struct TaskStats
+    {
+        uint32_t queued         = 0;
+        uint32_t executed       = 0;
+        float latency_avg_ms    = 0.0f; // time spent in the queue
+        float latency_max_ms    = 0.0f;
+    };
+
 	class Task
 	{
 	public:
-		typedef std::function<void()> function_type;
+        // Captures up to this size are stored inside the task, bigger ones fall back to the heap
+        static const size_t storage_size = 64;
 
-		Task(function_type&& function)  { m_function = std::forward<function_type>(function); }
-        void Execute()                  { m_is_executing = true; m_function(); m_is_executing = false; }
-        bool IsExecuting() const { return m_is_executing; }
+        Task() = default;
+        ~Task() { FunctionReset(); }
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
 
 	private:
-        bool m_is_executing = false;
-		function_type m_function;
+        friend class Threading;
+        friend class TaskHandle;
+
+        template <typename Function>
+        void FunctionSet(Function&& function)
+        {
+            typedef typename std::decay<Function>::type function_type;
+
+            FunctionReset();
+
+            if (sizeof(function_type) <= storage_size && alignof(function_type) <= alignof(std::max_align_t))
+            {
+                m_callable = new (m_storage) function_type(std::forward<Function>(function));
+                m_destroy  = [](void* callable) { static_cast<function_type*>(callable)->~function_type(); };
+            }
+            else
+            {
+                m_callable = new function_type(std::forward<Function>(function));
+                m_destroy  = [](void* callable) { delete static_cast<function_type*>(callable); };
+            }
+
+            m_invoke = [](void* callable) { (*static_cast<function_type*>(callable))(); };
+        }
+
+        void FunctionInvoke() { m_invoke(m_callable); }
+
+        // Destroys the captures, a task without a function is finished without executing anything
+        void FunctionReset()
+        {
+            if (!m_callable)
+                return;
+
+            m_destroy(m_callable);
+            m_callable  = nullptr;
+            m_invoke    = nullptr;
+            m_destroy   = nullptr;
+        }
+
+        alignas(std::max_align_t) unsigned char m_storage[storage_size];
+        void* m_callable                        = nullptr;
+        void (*m_invoke)(void*)                 = nullptr;
+        void (*m_destroy)(void*)                = nullptr;
+        Task* m_parent                          = nullptr;
+        Task* m_continuations                   = nullptr; // tasks to queue once this one is done (intrusive list)
+        Task* m_continuation_next               = nullptr;
+        uint64_t m_time_queued                  = 0;
+        Task_Priority m_priority                = Task_Normal;
+        bool m_background_slot                  = false; // a worker took this background task and counts towards the limit
+        std::atomic<uint32_t> m_unfinished      = 0; // the task itself plus any children which haven't finished yet
+        std::atomic<uint32_t> m_generation      = 0; // incremented every time the task is recycled
+        std::atomic<bool> m_lock                = false; // guards the continuations against the task finishing
 	};
 
+    // A lightweight reference to a task that can be waited on or used as a parent for other tasks.
+    // Tasks are pooled, so the generation is what tells a stale handle apart from a recycled task.
+    class TaskHandle
+    {
+    public:
+        TaskHandle() = default;
+        TaskHandle(Task* task, uint32_t generation) { m_task = task; m_generation = generation; }
+
+        bool IsValid() const { return m_task != nullptr; }
+        bool IsDone() const
+        {
+            if (!m_task)
+                return true;
+
+            if (m_task->m_unfinished.load(std::memory_order_acquire) == 0)
+                return true;
+
+            return m_task->m_generation.load(std::memory_order_acquire) != m_generation;
+        }
+
+    private:
+        friend class Threading;
+
+        Task* m_task            = nullptr;
+        uint32_t m_generation   = 0;
+    };
+
 	class Threading : public ISubsystem
 	{
 	public:
-		Threading(Context* context);
+		// thread_count includes the calling (main) thread, 0 uses as many as the hardware supports
+		Threading(Context* context, uint32_t thread_count = 0);
         ~Threading();
 
-		// Add a task
+		// Add a task, if a parent is provided, the parent will only be considered done once this task is done as well
 		template <typename Function>
-		void AddTask(Function&& function)
+		TaskHandle AddTask(Function&& function, const Task_Priority priority = Task_Normal, const TaskHandle& parent = TaskHandle())
 		{
 			if (m_threads.empty())
 			{
 				LOG_WARNING("No available threads, function will execute in the same thread");
 				function();
-				return;
+				return TaskHandle();
 			}
 
-			// Lock tasks mutex
-			std::unique_lock<std::mutex> lock(m_mutex_tasks);
+            Task* task = TaskAllocate();
+            task->FunctionSet(std::forward<Function>(function));
 
-			// Save the task
-			m_tasks.push_back(std::make_shared<Task>(std::bind(std::forward<Function>(function))));
+			return TaskSubmit(task, parent, priority);
+		}
 
-			// Unlock the mutex
-			lock.unlock();
+        // Adds a task which is only queued once the dependency is done, no thread is blocked in the meantime
+        template <typename Function>
+        TaskHandle AddTaskAfter(const TaskHandle& dependency, Function&& function, const Task_Priority priority = Task_Normal)
+        {
+            Task* task              = TaskAllocate();
+            task->FunctionSet(std::forward<Function>(function));
+            const TaskHandle handle = TaskPrepare(task, TaskHandle(), priority);
 
-			// Wake up a thread
-			m_condition_var.notify_one();
-		}
+            if (!TaskContinueAfter(task, dependency))
+            {
+                TaskQueue(task);
+            }
+
+            return handle;
+        }
+
+        // Adds a task which is queued once the current frame ends
+        template <typename Function>
+        TaskHandle AddTaskNextFrame(Function&& function, const Task_Priority priority = Task_Normal)
+        {
+            Task* task              = TaskAllocate();
+            task->FunctionSet(std::forward<Function>(function));
+            const TaskHandle handle = TaskPrepare(task, TaskHandle(), priority);
 
-        // Adds a task which is a loop and executes chunks of it in parallel
+            std::lock_guard<std::mutex> lock(m_mutex_tasks_next_frame);
+            m_tasks_next_frame.emplace_back(task);
+
+            return handle;
+        }
+
+        // Reads a file on the I/O thread, then adds a task which is passed the file's bytes (empty if the read failed).
+        // Workers don't sit idle waiting on the disk, so there can be many more reads in flight than there are threads.
         template <typename Function>
-        void AddTaskLoop(Function&& function, uint32_t range)
+        TaskHandle ReadFileAsync(const std::string& file_path, Function&& function, const Task_Priority priority = Task_Normal)
+        {
+            auto data               = std::make_shared<std::vector<std::byte>>();
+            Task* task              = TaskAllocate();
+            task->FunctionSet([data, function = std::forward<Function>(function)]() mutable { function(std::move(*data)); });
+            const TaskHandle handle = TaskPrepare(task, TaskHandle(), priority);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex_io);
+                m_io_requests.push_back({ file_path, data, task });
+            }
+            m_condition_var_io.notify_one();
+
+            return handle;
+        }
+
+        // Executes function(start, end) over [0, range) in parallel and returns once the whole range is done.
+        // Threads keep claiming chunks of grain_size until the range is exhausted, so a slow chunk doesn't hold
+        // back the rest, and the calling thread does its share instead of spinning. A grain size of 0 picks one.
+        template <typename Function>
+        void AddTaskLoop(Function&& function, uint32_t range, uint32_t grain_size = 0)
+        {
+            if (range == 0)
+                return;
+
+            const uint32_t grain        = grain_size != 0 ? grain_size : GetGrainSize(range);
+            const uint32_t chunk_count  = (range + grain - 1) / grain;
+
+            ExecuteChunks(chunk_count, [&function, grain, range](const uint32_t chunk)
+            {
+                const uint32_t start = chunk * grain;
+                function(start, std::min(start + grain, range));
+            });
+        }
+
+        // Like AddTaskLoop() but function(start, end) returns a partial result of type T which are then
+        // combined with reduce(T, T), in order, so the result is deterministic for non-commutative reductions.
+        template <typename T, typename Function, typename Reduce>
+        T AddTaskReduce(uint32_t range, const T& identity, Function&& function, Reduce&& reduce, uint32_t grain_size = 0)
         {
-            uint32_t available_threads  = GetThreadsAvailable();
-            vector<bool> tasks_done     = vector<bool>(available_threads, false);
-            const uint32_t task_count   = available_threads + 1; // plus one for the current thread
+            static_assert(!std::is_same<T, bool>::value, "std::vector<bool> can't be written to from multiple threads");
 
-            uint32_t start  = 0;
-            uint32_t end    = 0;
-            for (uint32_t i = 0; i < available_threads; i++)
+            if (range == 0)
+                return identity;
+
+            const uint32_t grain        = grain_size != 0 ? grain_size : GetGrainSize(range);
+            const uint32_t chunk_count  = (range + grain - 1) / grain;
+            std::vector<T> partials     = std::vector<T>(chunk_count, identity);
+
+            ExecuteChunks(chunk_count, [&function, &partials, grain, range](const uint32_t chunk)
             {
-                start   = (range / task_count) * i;
-                end     = start + (range / task_count);
+                const uint32_t start = chunk * grain;
+                partials[chunk] = function(start, std::min(start + grain, range));
+            });
+
+            T result = identity;
+            for (const T& partial : partials)
+            {
+                result = reduce(result, partial);
+            }
+
+            return result;
+        }
+
+        // Sorts [begin, end) by sorting chunks in parallel and then merging neighbouring runs in parallel passes
+        template <typename Iterator, typename Compare = std::less<>>
+        void AddTaskSort(Iterator begin, Iterator end, Compare compare = Compare(), uint32_t grain_size = 0)
+        {
+            const uint32_t count = static_cast<uint32_t>(std::distance(begin, end));
+            const uint32_t grain = grain_size != 0 ? grain_size : std::max(count / (m_thread_count + 1), 1024u);
 
-                // Kick off task
-                AddTask([&function, &tasks_done, i, start, end] { function(start, end); tasks_done[i] = true; });
+            if (count <= grain || m_threads.empty())
+            {
+                std::sort(begin, end, compare);
+                return;
             }
 
-            // Do last task in the current thread
-            function(end, range);
+            // Sort runs
+            AddTaskLoop([&begin, &compare](const uint32_t start, const uint32_t end)
+            {
+                std::sort(begin + start, begin + end, compare);
+            }, count, grain);
 
-            // Wait till the threads are done
-            uint32_t tasks = 0;
-            while (tasks != tasks_done.size())
+            // Merge runs, doubling their width on every pass
+            for (uint64_t width = grain; width < count; width *= 2)
             {
-                tasks = 0;
-                for (const bool job_done : tasks_done)
+                const uint32_t merge_count = static_cast<uint32_t>((count + 2 * width - 1) / (2 * width));
+
+                ExecuteChunks(merge_count, [&begin, &compare, width, count](const uint32_t merge)
                 {
-                    tasks += job_done ? 1 : 0;
-                }
+                    const uint64_t start    = merge * 2 * width;
+                    const uint64_t middle   = std::min<uint64_t>(start + width, count);
+                    const uint64_t end      = std::min<uint64_t>(start + 2 * width, count);
+
+                    if (middle < end)
+                    {
+                        std::inplace_merge(begin + start, begin + middle, begin + end, compare);
+                    }
+                });
             }
         }
 
+        // Blocks until the task (and its children) is done, the calling thread executes other tasks while waiting
+        void Wait(const TaskHandle& handle);
+        // Executes a queued task of at least the given priority on the calling thread, returns false if there was nothing to execute.
+        // Background tasks can take a while, so they are left to the workers unless the calling thread is running one already.
+        bool TaskExecuteNext(Task_Priority priority_lowest = Task_Normal);
         // Get the number of threads used
         uint32_t GetThreadCount()           const { return m_thread_count; }
         // Get the maximum number of threads the hardware supports
         uint32_t GetThreadCountSupport()    const { return m_thread_count_support; }
+        // Get the number of threads reserved for file reads
+        uint32_t GetThreadCountIo()         const { return static_cast<uint32_t>(m_threads_io.size()); }
         // Get the number of threads which are not doing any work
         uint32_t GetThreadsAvailable()      const;
+        // Get the stats of a priority class since the previous call
+        TaskStats GetTaskStats(Task_Priority priority);
         // Waits for all executing (and queued if requested) tasks to finish
         void Flush(bool removed_queued = false);
 
 	private:
-        // This function is invoked by the threads
-        void ThreadLoop();
+        static const uint32_t priority_count = Task_Background + 1;
+
+        // Calls function(chunk) for every chunk in [0, chunk_count) using as many threads as there is work for
+        template <typename Function>
+        void ExecuteChunks(const uint32_t chunk_count, Function&& function)
+        {
+            std::atomic<uint32_t> chunk_next = 0;
+            auto work = [&chunk_next, &function, chunk_count]()
+            {
+                for (uint32_t chunk = chunk_next++; chunk < chunk_count; chunk = chunk_next++)
+                {
+                    function(chunk);
+                }
+            };
+
+            // Only add as many helpers as there are chunks the calling thread won't get to, at the caller's priority
+            const uint32_t helper_count     = std::min(m_thread_count, chunk_count - 1);
+            const Task_Priority priority    = GetPriorityCurrent();
+            std::atomic<uint32_t> helpers_running = helper_count;
+            for (uint32_t i = 0; i < helper_count; i++)
+            {
+                // The decrement has to be the last access to this stack frame
+                AddTask([&work, &helpers_running]() { work(); helpers_running--; }, priority);
+            }
+
+            work();
+
+            // Helpers which didn't get to start will find no chunks left and exit right away
+            while (helpers_running.load() != 0)
+            {
+                if (!TaskExecuteNext(priority))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        // Picks a grain size that gives every thread a few chunks, so that threads which finish early can balance the load
+        uint32_t GetGrainSize(const uint32_t range) const { return std::max(range / ((m_thread_count + 1) * 8), 1u); }
+
+        // Per thread state, index 0 is the main thread, the rest are the workers
+        struct ThreadData
+        {
+            TaskDeque deques[priority_count]; // one per priority
+            std::vector<Task*> tasks_free;
+        };
+
+        // A file read which the I/O thread has to do before the task can be queued
+        struct IoRequest
+        {
+            std::string file_path;
+            std::shared_ptr<std::vector<std::byte>> data;
+            Task* task = nullptr;
+        };
+
+        // These functions are invoked by the threads
+        void ThreadLoop(uint32_t thread_index);
+        void ThreadLoopIo();
+
+        // Tasks
+        Task* TaskAllocate();
+        void TaskFree(Task* task);
+        TaskHandle TaskPrepare(Task* task, const TaskHandle& parent, Task_Priority priority);
+        void TaskQueue(Task* task);
+        TaskHandle TaskSubmit(Task* task, const TaskHandle& parent, const Task_Priority priority) { const TaskHandle handle = TaskPrepare(task, parent, priority); TaskQueue(task); return handle; }
+        bool TaskContinueAfter(Task* task, const TaskHandle& dependency);
+        void TaskCancel(Task* task);
+        void OnFrameEnd();
+        Task* TaskAcquire(uint32_t thread_index, Task_Priority priority_lowest);
+        Task_Priority GetPriorityCurrent() const;
+        Task* TaskAcquirePriority(uint32_t thread_index, Task_Priority priority);
+        void TaskExecute(Task* task);
+        void BackgroundSlotRelease();
+        void TaskFinish(Task* task);
+        void WakeThread();
+        ThreadData* GetThreadData(uint32_t thread_index) const { return thread_index < m_thread_data.size() ? m_thread_data[thread_index].get() : nullptr; }
 
 		uint32_t m_thread_count         = 0;
         uint32_t m_thread_count_support = 0;
 		std::vector<std::thread> m_threads;
-		std::deque<std::shared_ptr<Task>> m_tasks;
-		std::mutex m_mutex_tasks;
-		std::condition_variable m_condition_var;
+        std::vector<std::unique_ptr<ThreadData>> m_thread_data;
         std::unordered_map<std::thread::id, std::string> m_thread_names;
-		bool m_stopping;
+
+        // Tasks submitted by threads which are not owned by this subsystem, one queue per priority
+        std::deque<Task*> m_tasks_external[priority_count];
+        std::mutex m_mutex_tasks_external;
+        std::atomic<uint32_t> m_tasks_external_count[priority_count] = {};
+
+        // Tasks waiting for the current frame to end
+        std::vector<Task*> m_tasks_next_frame;
+        std::mutex m_mutex_tasks_next_frame;
+
+        // I/O
+        std::vector<std::thread> m_threads_io;
+        std::deque<IoRequest> m_io_requests;
+        std::mutex m_mutex_io;
+        std::condition_variable m_condition_var_io;
+
+        // Task pool, only touched when a thread runs out of (or accumulates too many) free tasks
+        std::vector<std::unique_ptr<Task[]>> m_task_blocks;
+        std::vector<Task*> m_tasks_free;
+        std::mutex m_mutex_task_pool;
+
+        // Sleeping
+		std::mutex m_mutex_sleep;
+		std::condition_variable m_condition_var;
+        std::atomic<uint32_t> m_threads_sleeping    = 0;
+
+        // Per priority stats
+        struct PriorityStats
+        {
+            std::atomic<int32_t> queued             = 0;
+            std::atomic<uint32_t> executed          = 0;
+            std::atomic<uint64_t> latency_ns        = 0;
+            std::atomic<uint64_t> latency_max_ns = 0;
+        };
+        PriorityStats m_task_stats[priority_count];
+        uint32_t m_background_limit                 = 0;
+        std::atomic<uint32_t> m_background_running  = 0;
+
+        // Stats
+        std::atomic<uint32_t> m_tasks_in_flight     = 0;
+        std::atomic<uint32_t> m_threads_busy        = 0;
+		std::atomic<bool> m_stopping                = false;
+
+        // Events
+        EventHandle m_event_frame_end;
 	};
 }
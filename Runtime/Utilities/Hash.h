@@ -21,6 +21,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
+//= INCLUDES ======
+#include <cstdint>
+#include <cstddef>
+//=================
+
 namespace Spartan::Utility::Hash
 {
     template <class T>
@@ -29,4 +34,17 @@ namespace Spartan::Utility::Hash
         std::hash<T> hasher;
         seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
     }
+
+    // Stable across runs and platforms (unlike std::hash), so it can key data on disk. Pass the previous result as the seed to hash in pieces.
+    inline uint64_t fnv1a_64(const void* data, const size_t size, uint64_t seed = 14695981039346656037ull)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            seed ^= bytes[i];
+            seed *= 1099511628211ull;
+        }
+
+        return seed;
+    }
 }
@@ -0,0 +1,287 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==============
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <algorithm>
+#include "Components/IComponent.h"
+//=========================
+
+namespace Spartan
+{
+    // Hands out fixed size slots from chunks, objects of the same type end up next to each other in memory
+    class ComponentPool
+    {
+    public:
+        ComponentPool(const size_t slot_size, const size_t alignment)
+        {
+            m_slot_size = slot_size;
+            m_alignment = alignment;
+        }
+
+        ~ComponentPool()
+        {
+            // The pools are owned by everything allocated from them, so nothing is alive at this point
+            for (std::byte* chunk : m_chunks)
+            {
+                ::operator delete(chunk, std::align_val_t(m_alignment));
+            }
+        }
+
+        void* Allocate()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (!m_free)
+            {
+                std::byte* chunk = static_cast<std::byte*>(::operator new(m_slot_size * slots_per_chunk, std::align_val_t(m_alignment)));
+                m_chunks.emplace_back(chunk);
+
+                // Link the slots in address order, so consecutive allocations are consecutive in memory
+                for (size_t i = slots_per_chunk; i-- > 0;)
+                {
+                    Slot* slot  = reinterpret_cast<Slot*>(chunk + i * m_slot_size);
+                    slot->next  = m_free;
+                    m_free      = slot;
+                }
+            }
+
+            Slot* slot = m_free;
+            m_free = slot->next;
+
+            return slot;
+        }
+
+        void Free(void* memory)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            Slot* slot  = static_cast<Slot*>(memory);
+            slot->next  = m_free;
+            m_free      = slot;
+        }
+
+        size_t GetSlotSize() const  { return m_slot_size; }
+        size_t GetAlignment() const { return m_alignment; }
+
+        struct Slot { Slot* next; };
+
+    private:
+        static constexpr size_t slots_per_chunk = 64;
+
+        size_t m_slot_size  = 0;
+        size_t m_alignment  = 0;
+        std::vector<std::byte*> m_chunks;
+        Slot* m_free        = nullptr;
+        std::mutex m_mutex;
+    };
+
+    // The pools of a world, one per slot size. Every component allocated from them shares their ownership,
+    // so they are released after the last component instead of at some point during static destruction.
+    class ComponentPools
+    {
+    public:
+        ComponentPool& Get(const size_t size, const size_t alignment)
+        {
+            const size_t slot_alignment = std::max(alignment, alignof(ComponentPool::Slot));
+            const size_t slot_size      = ((std::max(size, sizeof(ComponentPool::Slot)) + slot_alignment - 1) / slot_alignment) * slot_alignment;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for (const std::unique_ptr<ComponentPool>& pool : m_pools)
+            {
+                if (pool->GetSlotSize() == slot_size && pool->GetAlignment() == slot_alignment)
+                    return *pool;
+            }
+
+            return *m_pools.emplace_back(std::make_unique<ComponentPool>(slot_size, slot_alignment));
+        }
+
+    private:
+        std::vector<std::unique_ptr<ComponentPool>> m_pools;
+        std::mutex m_mutex;
+    };
+
+    // Allocator for std::allocate_shared, the component and its reference count share a pooled slot
+    template <class T>
+    class ComponentAllocator
+    {
+    public:
+        using value_type = T;
+
+        ComponentAllocator(const std::shared_ptr<ComponentPools>& pools) : m_pools(pools) {}
+        template <class U> ComponentAllocator(const ComponentAllocator<U>& other) : m_pools(other.m_pools) {}
+
+        T* allocate(const size_t count)
+        {
+            if (count != 1 || !m_pools)
+                return std::allocator<T>().allocate(count);
+
+            return static_cast<T*>(m_pools->Get(sizeof(T), alignof(T)).Allocate());
+        }
+
+        void deallocate(T* memory, const size_t count)
+        {
+            if (count != 1 || !m_pools)
+            {
+                std::allocator<T>().deallocate(memory, count);
+                return;
+            }
+
+            m_pools->Get(sizeof(T), alignof(T)).Free(memory);
+        }
+
+        template <class U> bool operator==(const ComponentAllocator<U>& other) const { return m_pools == other.m_pools; }
+        template <class U> bool operator!=(const ComponentAllocator<U>& other) const { return m_pools != other.m_pools; }
+
+    private:
+        template <class U> friend class ComponentAllocator;
+        std::shared_ptr<ComponentPools> m_pools;
+    };
+
+    // Packed array of all the components of one type in the world, with their entities stored alongside
+    class ComponentArray
+    {
+    public:
+        void Add(IComponent* component)
+        {
+            component->m_storage_index = static_cast<uint32_t>(m_components.size());
+            m_components.emplace_back(component);
+            m_entities.emplace_back(component->GetEntity());
+        }
+
+        void Remove(IComponent* component)
+        {
+            const uint32_t index = component->m_storage_index;
+            if (index >= m_components.size() || m_components[index] != component)
+                return;
+
+            // While locked the slot is only emptied, so nothing moves under whoever is walking the array
+            if (m_locked)
+            {
+                m_components[index]         = nullptr;
+                m_entities[index]           = nullptr;
+                m_removed_while_locked      = true;
+                component->m_storage_index  = IComponent::storage_index_invalid;
+                return;
+            }
+
+            // Move the last one in its place to keep the array packed
+            IComponent* last        = m_components.back();
+            last->m_storage_index   = index;
+            m_components[index]     = last;
+            m_entities[index]       = m_entities.back();
+            m_components.pop_back();
+            m_entities.pop_back();
+
+            component->m_storage_index = IComponent::storage_index_invalid;
+        }
+
+        void Clear()
+        {
+            for (IComponent* component : m_components)
+            {
+                if (component)
+                {
+                    component->m_storage_index = IComponent::storage_index_invalid;
+                }
+            }
+
+            m_components.clear();
+            m_entities.clear();
+            m_removed_while_locked = false;
+        }
+
+        // Lock while walking the array and calling into components, removed components leave empty (null) slots until unlocked
+        void Lock() { m_locked = true; }
+        void Unlock()
+        {
+            m_locked = false;
+            if (!m_removed_while_locked)
+                return;
+
+            // Pack the array again
+            uint32_t count = 0;
+            for (uint32_t i = 0; i < static_cast<uint32_t>(m_components.size()); i++)
+            {
+                if (IComponent* component = m_components[i])
+                {
+                    component->m_storage_index  = count;
+                    m_components[count]         = component;
+                    m_entities[count]           = m_entities[i];
+                    count++;
+                }
+            }
+            m_components.resize(count);
+            m_entities.resize(count);
+            m_removed_while_locked = false;
+        }
+
+        uint32_t GetCount() const                           { return static_cast<uint32_t>(m_components.size()); }
+        IComponent* const* GetComponents() const            { return m_components.data(); }
+        Entity* const* GetEntities() const                  { return m_entities.data(); }
+
+        // How many were parallel safe when the world last ticked them, decides if the type is worth handing to the workers
+        uint32_t GetParallelSafeCount() const               { return m_parallel_safe_count; }
+        void SetParallelSafeCount(const uint32_t count)     { m_parallel_safe_count = count; }
+
+    private:
+        std::vector<IComponent*> m_components;
+        std::vector<Entity*> m_entities;
+        uint32_t m_parallel_safe_count = 0;
+        bool m_locked                   = false;
+        bool m_removed_while_locked     = false;
+    };
+
+    // Typed view over a component array, for iterating every component of type T in the world
+    template <class T>
+    class ComponentView
+    {
+    public:
+        class Iterator
+        {
+        public:
+            Iterator(IComponent* const* component) : m_component(component) {}
+            T* operator*() const                            { return static_cast<T*>(*m_component); }
+            Iterator& operator++()                          { ++m_component; return *this; }
+            bool operator!=(const Iterator& other) const    { return m_component != other.m_component; }
+
+        private:
+            IComponent* const* m_component;
+        };
+
+        ComponentView(const ComponentArray& components) : m_components(components) {}
+
+        uint32_t GetCount() const                       { return m_components.GetCount(); }
+        T* GetComponent(const uint32_t index) const     { return static_cast<T*>(m_components.GetComponents()[index]); }
+        Entity* GetEntity(const uint32_t index) const   { return m_components.GetEntities()[index]; }
+        Iterator begin() const                          { return Iterator(m_components.GetComponents()); }
+        Iterator end() const                            { return Iterator(m_components.GetComponents() + m_components.GetCount()); }
+
+    private:
+        const ComponentArray& m_components;
+    };
+}
@@ -44,4 +44,12 @@ namespace Spartan
 
 		m_audio->SetListenerTransform(GetTransform());
 	}
+
+	void AudioListener::OnRemove()
+	{
+		if (!m_audio)
+			return;
+
+		m_audio->SetListenerTransform(nullptr);
+	}
 }
@@ -38,6 +38,7 @@ namespace Spartan
         //= COMPONENT =========================
         void OnInitialize() override;
         void OnTick(float delta_time) override;
+        void OnRemove() override;
         //=====================================
 
 	private:
@@ -43,6 +43,7 @@ namespace Spartan
 		void OnStop() override;
 		void OnRemove() override;
 		void OnTick(float delta_time) override;
+		bool IsTickParallelSafe() const override { return true; } // fmod is initialized thread safe
 		void Serialize(FileStream* stream) override;
 		void Deserialize(FileStream* stream) override;
 		//============================================
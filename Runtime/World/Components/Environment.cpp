@@ -68,7 +68,7 @@ namespace Spartan
         m_context->GetSubsystem<Threading>()->AddTask([this]
         {
             SetFromTextureSphere(m_file_paths.front());
-        });
+        }, Task_Background);
 
         m_is_dirty = false;
     }
@@ -96,7 +96,7 @@ namespace Spartan
                 
                 SetFromTextureSphere(m_file_paths.front());
             }
-        });
+        }, Task_Background);
     }
 
     void Environment::LoadDefault()
@@ -83,6 +83,10 @@ namespace Spartan
 		// Runs every frame
 		virtual void OnTick(float delta_time) {}
 
+		// Whether OnTick() can run on the thread pool, alongside other components of the same type.
+		// It may only touch the component's own data, read transforms and call thread safe systems.
+		virtual bool IsTickParallelSafe() const { return false; }
+
 		// Runs when the entity is being saved
 		virtual void Serialize(FileStream* stream) {}
 
@@ -149,7 +153,12 @@ namespace Spartan
 		Transform* m_transform	= nullptr;
 
 	private:
+		friend class ComponentArray;
+		static const uint32_t storage_index_invalid = static_cast<uint32_t>(-1);
+
 		// The attributes of the component
 		std::vector<Attribute> m_attributes;
+		// The position of the component in the world's array of its type
+		uint32_t m_storage_index = storage_index_invalid;
 	};
 }
@@ -170,9 +170,6 @@ namespace Spartan
         {
             CreateShadowMap();
         }
-
-        
-        m_context->GetSubsystem<World>()->MakeDirty();
 	}
 
 	void Light::SetShadowsEnabled(bool cast_shadows)
@@ -70,6 +70,7 @@ namespace Spartan
 		void OnInitialize() override;
 		void OnStart() override;
 		void OnTick(float delta_time) override;
+		bool IsTickParallelSafe() const override { return m_initialized; } // the first tick creates the shadow map
 		void Serialize(FileStream* stream) override;
 		void Deserialize(FileStream* stream) override;
 		//============================================
@@ -152,7 +152,7 @@ namespace Spartan
             m_progress_desc.clear();
 
             m_is_generating = false;
-        });
+        }, Task_Background);
     }
 
     bool Terrain::GeneratePositions(vector<Vector3>& positions, const vector<std::byte>& height_map)
@@ -21,6 +21,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =====================
 #include "Transform.h"
+#include <thread>
+#include <algorithm>
 #include "../World.h"
 #include "../Entity.h"
 #include "../../Core/Context.h"
@@ -80,7 +82,15 @@ namespace Spartan
 		{
 			if (const auto parent = GetContext()->GetSubsystem<World>()->EntityGetById(parententity_id))
 			{
-				parent->GetTransform()->AddChild(this);
+                // While loading, only the parent is known, the world adds the children once all the entities are there
+                if (!GetEntity()->IsInWorld())
+                {
+                    m_parent = parent->GetTransform();
+                }
+                else
+                {
+				    parent->GetTransform()->AddChild(this);
+                }
 			}
 		}
 
@@ -89,24 +99,52 @@ namespace Spartan
 	//===============================================================================================
 	void Transform::UpdateTransform()
 	{
-		// Compute local transform
-		m_matrixLocal = Matrix(m_positionLocal, m_rotationLocal, m_scaleLocal);
+		m_is_dirty_local = true;
+		MarkDirty();
+	}
 
-		// Compute world transform
-		if (!HasParent())
+	void Transform::MarkDirty()
+	{
+		// Already dirty means the descendants are too, so repeated writes in a frame stop here
+		if (m_is_dirty.load(memory_order_relaxed))
+			return;
+
+		m_is_dirty.store(true, memory_order_relaxed);
+		for (Transform* child : m_children)
 		{
-			m_matrix = m_matrixLocal;
+			child->MarkDirty();
 		}
-		else
+
+		// Let the world know it has transforms to update
+		if (World* world = m_entity ? m_entity->GetWorld() : nullptr)
 		{
-			m_matrix = m_matrixLocal * GetParentTransformMatrix();
+			world->TransformsMarkChanged();
 		}
-		
-		// Update children
-		for (const auto& child : m_children)
+	}
+
+	void Transform::Resolve() const
+	{
+		// Only one thread resolves, the others wait and then find it clean. The parent is locked while this one is
+		// held (by reading its matrix), locks are always taken from child to parent so they can't deadlock.
+		while (m_resolve_lock.exchange(true, memory_order_acquire))
 		{
-			child->UpdateTransform();
+			this_thread::yield();
 		}
+
+		if (m_is_dirty.load(memory_order_relaxed))
+		{
+			if (m_is_dirty_local)
+			{
+				m_matrixLocal       = Matrix(m_positionLocal, m_rotationLocal, m_scaleLocal);
+				m_is_dirty_local    = false;
+			}
+
+			// Reading the parent's matrix resolves it first, if needed
+			m_matrix = HasParent() ? m_matrixLocal * m_parent->GetMatrix() : m_matrixLocal;
+			m_is_dirty.store(false, memory_order_release);
+		}
+
+		m_resolve_lock.store(false, memory_order_release);
 	}
 
 	//= TRANSLATION ==================================================================================
@@ -258,11 +296,14 @@ namespace Spartan
 		// if the new parent is a descendant of this transform
 		if (new_parent->IsDescendantOf(this))
 		{
+			// the children remove themselves from this transform as they move, so walk a copy
+			const vector<Transform*> children = m_children;
+
 			// if this transform already has a parent
 			if (this->HasParent())
 			{
 				// assign the parent of this transform to the children
-				for (const auto& child : m_children)
+				for (const auto& child : children)
 				{
 					child->SetParent(GetParent());
 				}
@@ -270,7 +311,7 @@ namespace Spartan
 			else // if this transform doesn't have a parent
 			{
 				// make the children orphans
-				for (const auto& child : m_children)
+				for (const auto& child : children)
 				{
 					child->BecomeOrphan();
 				}
@@ -280,15 +321,16 @@ namespace Spartan
 		// Switch parent but keep a pointer to the old one
 		auto parent_old = m_parent;
 		m_parent = new_parent;
-		if (parent_old) parent_old->AcquireChildren(); // update the old parent (so it removes this child)
 
-		// make the new parent "aware" of this transform/child
-		if (m_parent)
+		// Move this child from the old parent to the new one, instead of having them search the world for their children
+		if (parent_old)
 		{
-			m_parent->AcquireChildren();
+			parent_old->m_children.erase(remove(parent_old->m_children.begin(), parent_old->m_children.end(), this), parent_old->m_children.end());
 		}
+		m_parent->m_children.emplace_back(this);
 
 		UpdateTransform();
+		GetContext()->GetSubsystem<World>()->TransformsMakeDirty();
 	}
 
 	void Transform::AddChild(Transform* child)
@@ -394,11 +436,6 @@ namespace Spartan
 		}
 	}
 
-    Matrix Transform::GetParentTransformMatrix() const
-	{
-		return HasParent() ? GetParent()->GetMatrix() : Matrix::Identity;
-	}
-
 	// Makes this transform have no parent
 	void Transform::BecomeOrphan()
 	{
@@ -414,13 +451,9 @@ namespace Spartan
 
 		// Update the transform without the parent now
 		UpdateTransform();
+		GetContext()->GetSubsystem<World>()->TransformsMakeDirty();
 
-		// make the parent search for children,
-		// that's indirect way of making the parent "forget"
-		// about this child, since it won't be able to find it
-		if (temp_ref)
-		{
-			temp_ref->AcquireChildren();
-		}
+		// make the parent forget about this child
+		temp_ref->m_children.erase(remove(temp_ref->m_children.begin(), temp_ref->m_children.end(), this), temp_ref->m_children.end());
 	}
 }
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include "IComponent.h"
 #include <vector>
+#include <atomic>
 #include "../../Math/Vector3.h"
 #include "../../Math/Quaternion.h"
 #include "../../Math/Matrix.h"
@@ -46,24 +47,26 @@ namespace Spartan
 		void Deserialize(FileStream* stream) override;
 		//============================================
 
+		// Marks the transform (and its descendants) as changed, the matrices are computed when first read
+		// or by the world, once per frame, whichever comes first.
 		void UpdateTransform();
 
 		//= POSITION ==============================================================
-		auto GetPosition()              const { return m_matrix.GetTranslation(); }
+		auto GetPosition()              const { return GetMatrix().GetTranslation(); }
 		const auto& GetPositionLocal()  const { return m_positionLocal; }
 		void SetPosition(const Math::Vector3& position);
 		void SetPositionLocal(const Math::Vector3& position);
 		//=========================================================================
 
 		//= ROTATION ===========================================================
-		Math::Quaternion GetRotation() const { return m_matrix.GetRotation(); }
+		Math::Quaternion GetRotation() const { return GetMatrix().GetRotation(); }
 		const auto& GetRotationLocal() const { return m_rotationLocal; }
 		void SetRotation(const Math::Quaternion& rotation);
 		void SetRotationLocal(const Math::Quaternion& rotation);
 		//======================================================================
 
 		//= SCALE =======================================================
-		auto GetScale()             const { return m_matrix.GetScale(); }
+		auto GetScale()             const { return GetMatrix().GetScale(); }
 		const auto& GetScaleLocal() const { return m_scaleLocal; }
 		void SetScale(const Math::Vector3& scale);
 		void SetScaleLocal(const Math::Vector3& scale);
@@ -103,23 +106,33 @@ namespace Spartan
 		//======================================================================================
 
 		void LookAt(const Math::Vector3& v)                       { m_lookAt = v; }
-		const Math::Matrix& GetMatrix()                     const { return m_matrix; }     
-		const Math::Matrix& GetLocalMatrix()                const { return m_matrixLocal; }
+		const Math::Matrix& GetMatrix()                     const { if (IsDirty()) Resolve(); return m_matrix; }
+		const Math::Matrix& GetLocalMatrix()                const { if (IsDirty()) Resolve(); return m_matrixLocal; }
+		bool IsDirty()                                      const { return m_is_dirty.load(std::memory_order_acquire); }
         const Math::Matrix& GetWvpLastFrame()               const { return m_wvp_previous; }
         void SetWvpLastFrame(const Math::Matrix& matrix)          { m_wvp_previous = matrix;}
 
 	private:
-		Math::Matrix GetParentTransformMatrix() const;
+		friend class World;
+
+		void MarkDirty();
+		void Resolve() const;
 
 		// local
 		Math::Vector3 m_positionLocal;
 		Math::Quaternion m_rotationLocal;
 		Math::Vector3 m_scaleLocal;
 
-		Math::Matrix m_matrix;
-		Math::Matrix m_matrixLocal;
+		mutable Math::Matrix m_matrix;
+		mutable Math::Matrix m_matrixLocal;
 		Math::Vector3 m_lookAt;
 
+		// A dirty transform implies dirty descendants, so a clean one can trust its parent's matrix. Threads which read the same
+		// dirty transform at once resolve it one at a time, the matrices are published by clearing the flag.
+		mutable std::atomic<bool> m_is_dirty        = true;
+		mutable std::atomic<bool> m_resolve_lock    = false;
+		mutable bool m_is_dirty_local               = true;
+
 		Transform* m_parent; // the parent of this transform
 		std::vector<Transform*> m_children; // the children of this transform
 
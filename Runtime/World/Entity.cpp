@@ -211,8 +211,8 @@ namespace Spartan
         {
             stream->Read(&m_is_active);
             stream->Read(&m_hierarchy_visibility);
-            stream->Read(&m_id);
-            stream->Read(&m_name);
+            SetId(stream->ReadAs<uint32_t>());
+            SetName(stream->ReadAs<string>());
         }
 
         // COMPONENTS
@@ -313,6 +313,7 @@ namespace Spartan
 			{
                 component_type = component->GetType();
 				component->OnRemove();
+				OnComponentRemoved(component.get());
 				it = m_components.erase(it);    
                 break;
 			}
@@ -336,6 +337,72 @@ namespace Spartan
         }
 
 		// Make the scene resolve
-		FIRE_EVENT(Event_World_Resolve_Pending);
+        if (m_world)
+        {
+		    FIRE_EVENT(Event_World_Resolve_Pending);
+        }
 	}
+
+    shared_ptr<ComponentPools> Entity::GetComponentPools() const
+    {
+        World* world = m_world ? m_world : m_context->GetSubsystem<World>();
+        return world ? world->GetComponentPools() : nullptr;
+    }
+
+    void Entity::OnComponentAdded(IComponent* component)
+    {
+        if (m_world)
+        {
+            m_world->ComponentRegister(component);
+        }
+    }
+
+    void Entity::OnComponentRemoved(IComponent* component)
+    {
+        if (m_world)
+        {
+            m_world->ComponentUnregister(component);
+        }
+    }
+
+    void Entity::SetName(const string& name)
+    {
+        if (m_name == name)
+            return;
+
+        const string name_old = m_name;
+        m_name = name;
+
+        if (m_world)
+        {
+            m_world->EntityRenamed(this, name_old);
+        }
+    }
+
+    void Entity::SetId(const uint32_t id)
+    {
+        const uint32_t id_old = GetId();
+        if (id_old == id)
+            return;
+
+        Spartan_Object::SetId(id);
+
+        if (m_world)
+        {
+            m_world->EntityIdChanged(this, id_old);
+        }
+    }
+
+    void Entity::SetActive(const bool active)
+    {
+        if (m_is_active == active)
+            return;
+
+        m_is_active = active;
+
+        if (m_world)
+        {
+            m_world->EntityChanged(this);
+        }
+    }
 }
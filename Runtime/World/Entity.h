@@ -24,12 +24,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <vector>
 #include "../Core/EventSystem.h"
-#include "Components/IComponent.h"
+#include "ComponentStorage.h"
 //================================
 
 namespace Spartan
 {
 	class Context;
+	class World;
 	class Transform;
 	class Renderable;
 	
@@ -48,10 +49,13 @@ namespace Spartan
 
 		//= PROPERTIES ===================================================================================================
 		const std::string& GetName() const								{ return m_name; }
-		void SetName(const std::string& name)							{ m_name = name; }
+		void SetName(const std::string& name);
+
+		// The world re-indexes the entity
+		void SetId(uint32_t id) override;
 
 		bool IsActive() const											{ return m_is_active; }
-		void SetActive(const bool active)								{ m_is_active = active; }
+		void SetActive(bool active);
 
 		bool IsVisibleInHierarchy() const								{ return m_hierarchy_visibility; }
 		void SetHierarchyVisibility(const bool hierarchy_visibility)	{ m_hierarchy_visibility = hierarchy_visibility; }
@@ -67,8 +71,8 @@ namespace Spartan
 			if (HasComponent(type) && type != ComponentType_Script)
 				return GetComponent<T>();
 
-            // Create a new component
-            std::shared_ptr<T> component = std::make_shared<T>(m_context, this, id);
+            // Create a new component, the pool keeps components of the same type together
+            std::shared_ptr<T> component = std::allocate_shared<T>(ComponentAllocator<T>(GetComponentPools()), m_context, this, id);
 
             // Save new component
             m_components.emplace_back(std::static_pointer_cast<IComponent>(component));
@@ -81,9 +85,13 @@ namespace Spartan
             // Initialize component
             component->SetType(type);
             component->OnInitialize();
+            OnComponentAdded(component.get());
 
-			// Make the scene resolve
-			FIRE_EVENT(Event_World_Resolve_Pending);
+			// Make the scene resolve, entities which aren't in it yet (e.g. while they are loaded) are resolved once they are added
+            if (m_world)
+            {
+			    FIRE_EVENT(Event_World_Resolve_Pending);
+            }
 
             return component.get();
 		}
@@ -149,6 +157,7 @@ namespace Spartan
 				if (component->GetType() == type)
 				{
 					component->OnRemove();
+					OnComponentRemoved(component.get());
 					it = m_components.erase(it);
                     m_component_mask &= ~GetComponentMask(type);
 				}
@@ -159,12 +168,19 @@ namespace Spartan
 			}
 
 			// Make the scene resolve
-			FIRE_EVENT(Event_World_Resolve_Pending);
+            if (m_world)
+            {
+			    FIRE_EVENT(Event_World_Resolve_Pending);
+            }
 		}
 
 		void RemoveComponentById(uint32_t id);
 		const auto& GetAllComponents() const { return m_components; }
 
+        // Entities are in the world once they are added to it, the ones which are being loaded aren't yet and must not touch it
+        bool IsInWorld() const              { return m_world != nullptr; }
+        World* GetWorld() const             { return m_world; }
+
         void MarkForDestruction()           { m_destruction_pending = true; }
         bool IsPendingDestruction() const   { return m_destruction_pending; }
 
@@ -174,6 +190,13 @@ namespace Spartan
 		std::shared_ptr<Entity> GetPtrShared()  { return shared_from_this(); }
 
 	private:
+        friend class World;
+
+        // Keep the world's component arrays in sync, when the entity is in a world
+        void OnComponentAdded(IComponent* component);
+        void OnComponentRemoved(IComponent* component);
+        // The pools of the world components are allocated from, even before the entity is added to it
+        std::shared_ptr<ComponentPools> GetComponentPools() const;
         constexpr uint32_t GetComponentMask(ComponentType type) { return static_cast<uint32_t>(1) << static_cast<uint32_t>(type); }
 
 		std::string m_name			= "Entity";
@@ -182,6 +205,9 @@ namespace Spartan
 		Transform* m_transform		= nullptr;
 		Renderable* m_renderable	= nullptr;
         bool m_destruction_pending  = false;
+        World* m_world              = nullptr;
+        bool m_resolve_added        = false; // in the world's list of entities added since it last resolved
+        bool m_resolve_changed      = false; // in the world's list of entities changed since it last resolved
 		
         // Components
         std::vector<std::shared_ptr<IComponent>> m_components;
@@ -0,0 +1,156 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =========
+#include "EntityIndex.h"
+#include <algorithm>
+#include "Entity.h"
+//====================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    static const shared_ptr<Entity> entity_empty;
+
+    template <typename Entry>
+    static const shared_ptr<Entity>& get_first(const vector<Entry>& bucket)
+    {
+        const Entry* first = &bucket.front();
+        for (const Entry& entry : bucket)
+        {
+            first = entry.order < first->order ? &entry : first;
+        }
+
+        return first->entity;
+    }
+
+    template <typename Key>
+    void EntityIndex::Insert(unordered_map<Key, vector<Entry>>& buckets, const Key& key, const shared_ptr<Entity>& entity, uint32_t Slots::* slot)
+    {
+        Slots& slots            = m_slots[entity.get()];
+        vector<Entry>& bucket   = buckets[key];
+        slots.*slot             = static_cast<uint32_t>(bucket.size());
+        bucket.push_back({ entity, slots.order });
+    }
+
+    template <typename Key>
+    void EntityIndex::Erase(unordered_map<Key, vector<Entry>>& buckets, const Key& key, const Entity* entity, uint32_t Slots::* slot)
+    {
+        const auto it_slots = m_slots.find(entity);
+        const auto it       = buckets.find(key);
+        if (it_slots == m_slots.end() || it == buckets.end())
+            return;
+
+        vector<Entry>& bucket   = it->second;
+        const uint32_t index    = it_slots->second.*slot;
+        if (index >= bucket.size() || bucket[index].entity.get() != entity)
+            return;
+
+        // Swap and pop
+        if (index + 1 != bucket.size())
+        {
+            bucket[index] = move(bucket.back());
+            m_slots[bucket[index].entity.get()].*slot = index;
+        }
+        bucket.pop_back();
+
+        // Don't keep empty keys around
+        if (bucket.empty())
+        {
+            buckets.erase(it);
+        }
+    }
+
+    void EntityIndex::Add(const shared_ptr<Entity>& entity)
+    {
+        m_slots[entity.get()].order = m_order_next++;
+        Insert(m_by_id, entity->GetId(), entity, &Slots::id);
+        Insert(m_by_name, entity->GetName(), entity, &Slots::name);
+    }
+
+    void EntityIndex::Remove(const Entity* entity)
+    {
+        Erase(m_by_id, entity->GetId(), entity, &Slots::id);
+        Erase(m_by_name, entity->GetName(), entity, &Slots::name);
+        m_slots.erase(entity);
+    }
+
+    void EntityIndex::Clear()
+    {
+        m_by_id.clear();
+        m_by_name.clear();
+        m_slots.clear();
+    }
+
+    void EntityIndex::OnRenamed(Entity* entity, const string& name_old)
+    {
+        if (m_slots.find(entity) == m_slots.end())
+            return;
+
+        Erase(m_by_name, name_old, entity, &Slots::name);
+        Insert(m_by_name, entity->GetName(), entity->GetPtrShared(), &Slots::name);
+    }
+
+    void EntityIndex::OnIdChanged(Entity* entity, const uint32_t id_old)
+    {
+        if (m_slots.find(entity) == m_slots.end())
+            return;
+
+        Erase(m_by_id, id_old, entity, &Slots::id);
+        Insert(m_by_id, entity->GetId(), entity->GetPtrShared(), &Slots::id);
+    }
+
+    const shared_ptr<Entity>& EntityIndex::GetById(const uint32_t id) const
+    {
+        const auto it = m_by_id.find(id);
+        return it != m_by_id.end() ? get_first(it->second) : entity_empty;
+    }
+
+    const shared_ptr<Entity>& EntityIndex::GetByName(const string& name) const
+    {
+        const auto it = m_by_name.find(name);
+        return it != m_by_name.end() ? get_first(it->second) : entity_empty;
+    }
+
+    vector<shared_ptr<Entity>> EntityIndex::GetAllByName(const string& name) const
+    {
+        vector<shared_ptr<Entity>> entities;
+
+        const auto it = m_by_name.find(name);
+        if (it == m_by_name.end())
+            return entities;
+
+        // Sorted on demand, removals don't keep the order
+        vector<Entry> bucket = it->second;
+        sort(bucket.begin(), bucket.end(), [](const Entry& a, const Entry& b) { return a.order < b.order; });
+
+        entities.reserve(bucket.size());
+        for (Entry& entry : bucket)
+        {
+            entities.emplace_back(move(entry.entity));
+        }
+
+        return entities;
+    }
+}
@@ -0,0 +1,78 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==============
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "../Core/EngineDefs.h"
+//=========================
+
+namespace Spartan
+{
+    class Entity;
+
+    // Id and name lookups over a set of entities, the owner reports renames and id changes
+    class SPARTAN_CLASS EntityIndex
+    {
+    public:
+        void Add(const std::shared_ptr<Entity>& entity);
+        void Remove(const Entity* entity);
+        void Clear();
+        void OnRenamed(Entity* entity, const std::string& name_old);
+        void OnIdChanged(Entity* entity, uint32_t id_old);
+
+        const std::shared_ptr<Entity>& GetById(uint32_t id) const;
+        const std::shared_ptr<Entity>& GetByName(const std::string& name) const;
+        std::vector<std::shared_ptr<Entity>> GetAllByName(const std::string& name) const; // in the order they were added
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<Entity> entity;
+            uint64_t order = 0; // when it was added
+        };
+
+        // Where an entity is in its id and name buckets, so removing it is a swap with the last entry instead of a search
+        struct Slots
+        {
+            uint32_t id     = 0;
+            uint32_t name   = 0;
+            uint64_t order  = 0;
+        };
+
+        template <typename Key>
+        void Insert(std::unordered_map<Key, std::vector<Entry>>& buckets, const Key& key, const std::shared_ptr<Entity>& entity, uint32_t Slots::* slot);
+        template <typename Key>
+        void Erase(std::unordered_map<Key, std::vector<Entry>>& buckets, const Key& key, const Entity* entity, uint32_t Slots::* slot);
+
+        // Ids and names aren't guaranteed to be unique, lookups return the first entity that was added and the rest take over once it's gone.
+        // Buckets aren't kept in that order (removal swaps), so it's recovered from the entries when there is more than one.
+        std::unordered_map<uint32_t, std::vector<Entry>> m_by_id;
+        std::unordered_map<std::string, std::vector<Entry>> m_by_name;
+        std::unordered_map<const Entity*, Slots> m_slots;
+        uint64_t m_order_next = 0;
+    };
+}
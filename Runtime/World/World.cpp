@@ -21,6 +21,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==========================
 #include "World.h"
+#include <array>
+#include <algorithm>
 #include "Entity.h"
 #include "Components/Transform.h"
 #include "Components/Camera.h"
@@ -35,6 +37,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Profiling/Profiler.h"
 #include "../Rendering/Renderer.h"
 #include "../Input/Input.h"
+#include "../Threading/Threading.h"
+#include "../Utilities/Hash.h"
 //=====================================
 
 //= NAMESPACES ================
@@ -44,16 +48,116 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    // World files start with a header and an offset table, then each root entity's subtree follows as its own chunk.
+    // Files without the magic predate chunks, they start with the root entity count.
+    static const uint32_t world_magic   = 0x444C5753; // "SWLD"
+    static const uint32_t world_version = 3;            // 3: each component group is prefixed with its size
+
+    // Component data of one type within a chunk
+    struct WorldChunkGroup
+    {
+        uint32_t type           = ComponentType_Unknown;
+        uint32_t count          = 0;
+        const std::byte* data   = nullptr;
+        uint64_t size           = 0;
+    };
+
+    struct WorldChunkComponent
+    {
+        Entity* entity  = nullptr;
+        uint32_t type   = ComponentType_Unknown;
+        uint32_t id     = 0;
+        uint32_t index  = 0; // position among the entity's components
+    };
+
+    struct WorldChunk
+    {
+        // Offset table entry
+        uint32_t root_id    = 0;
+        uint64_t offset     = 0; // from the start of the file, the chunk is written with its size in front
+        uint64_t size       = 0;
+        uint64_t checksum   = 0;
+
+        // Loading
+        uint32_t version        = world_version;
+        const std::byte* data   = nullptr;
+        bool loaded             = false;
+        vector<shared_ptr<Entity>> entities;
+        vector<WorldChunkComponent> components_deferred;
+        vector<WorldChunkGroup> groups_deferred;
+    };
+
+    static const uint64_t world_header_size         = sizeof(uint32_t) * 3;
+    static const uint64_t world_chunk_entry_size    = sizeof(uint32_t) + sizeof(uint64_t) * 3;
+
+    // Entities which are being loaded aren't in the world yet, lookups from the thread loading them can still find them
+    static thread_local const EntityIndex* entities_loading = nullptr;
+
+    // Components which only touch their own data and thread safe systems (like the resource cache) when they are created
+    // and deserialized, these are loaded on the thread pool. The rest (physics, scripting, etc.) finish on the loading thread.
+    static bool is_parallel_safe(const uint32_t type)
+    {
+        switch (type)
+        {
+            case ComponentType_AudioListener:   return true;
+            case ComponentType_AudioSource:     return true;
+            case ComponentType_Camera:          return true;
+            case ComponentType_Light:           return true;
+            case ComponentType_Renderable:      return true;
+            case ComponentType_Transform:       return true;
+            default:                            return false;
+        }
+    }
+
+    // Deserializes count components of the given type, in entity order
+    static bool deserialize_components(FileStream* stream, const vector<shared_ptr<Entity>>& entities, const uint32_t type, const uint32_t count)
+    {
+        uint32_t component_index = 0;
+        for (const auto& entity : entities)
+        {
+            for (const auto& component : entity->GetAllComponents())
+            {
+                if (component->GetType() != type)
+                    continue;
+
+                if (component_index++ < count)
+                {
+                    component->Deserialize(stream);
+                }
+            }
+        }
+
+        if (component_index != count)
+        {
+            LOG_ERROR("Component data doesn't match the entities");
+            return false;
+        }
+
+        return true;
+    }
+
 	World::World(Context* context) : ISubsystem(context)
 	{
+        // Components can touch pretty much anything and events fire from here, has to tick on the main thread
+        SetTickDependencies(
+            SubsystemData_Time | SubsystemData_Input | SubsystemData_Resources | SubsystemData_Profiling,
+            SubsystemData_World | SubsystemData_Physics | SubsystemData_Audio | SubsystemData_Scripting | SubsystemData_Rendering,
+            true
+        );
+
 		// Subscribe to events
-		SUBSCRIBE_TO_EVENT(Event_World_Resolve_Pending, [this](Variant) { m_is_dirty = true; });
-		SUBSCRIBE_TO_EVENT(Event_World_Stop,	        [this](Variant)	{ m_state = Idle; });
-		SUBSCRIBE_TO_EVENT(Event_World_Start,	        [this](Variant)	{ m_state = Ticking; });
+		m_event_world_resolve_pending   = SUBSCRIBE_TO_EVENT(Event_World_Resolve_Pending,   [this](Variant) { m_is_dirty = true; });
+		m_event_world_stop              = SUBSCRIBE_TO_EVENT(Event_World_Stop,	            [this](Variant)	{ m_state = Idle; });
+		m_event_world_start             = SUBSCRIBE_TO_EVENT(Event_World_Start,	            [this](Variant)	{ m_state = Ticking; });
 	}
 
 	World::~World()
 	{
+		// Unsubscribe from events
+		UNSUBSCRIBE_FROM_EVENT(m_event_world_resolve_pending);
+		UNSUBSCRIBE_FROM_EVENT(m_event_world_stop);
+		UNSUBSCRIBE_FROM_EVENT(m_event_world_start);
+
 		Unload();
         m_input     = nullptr;
         m_profiler  = nullptr;
@@ -109,32 +213,101 @@ namespace Spartan
                 }
             }
 
-            // Tick
-            for (const auto& entity : m_entities)
+            // Tick a component type at a time, so each pass walks one packed array.
+            // Transforms and cameras tick first, on this thread, as the rest of the components read them (e.g. lights fit
+            // their shadow cascades to the camera). Then the parallel safe components tick, as type batched jobs. They only
+            // read transforms, so those are brought up to date beforehand instead of lazily from several threads.
+            // The rest tick on this thread, in the order of their types.
+            static const uint32_t parallel_threshold    = 64;
+            static const uint32_t parallel_grain        = 32;
+            Threading* threading = m_context->GetSubsystem<Threading>();
+
+            // Indexing (instead of iterators) allows components to be added while ticking, the array is locked so
+            // removed ones leave an empty slot instead of moving another component into a slot which was already visited.
+            // The parallel safe ones are counted on the way, for next tick's dispatch decision.
+            auto tick_serial = [delta_time](ComponentArray& components)
             {
-                entity->Tick(delta_time);
-            }
-		}
+                uint32_t parallel_safe_count = 0;
+                components.Lock();
+                for (uint32_t i = 0; i < components.GetCount(); i++)
+                {
+                    IComponent* component = components.GetComponents()[i];
+                    if (!component)
+                        continue;
 
-        if (m_is_dirty)
-        {
-            // Update dirty entities
-            {
-                // Make a copy so we can iterate while removing entities
-                auto entities_copy = m_entities;
+                    const bool parallel_safe = component->IsTickParallelSafe();
+                    if (!parallel_safe && components.GetEntities()[i]->IsActive())
+                    {
+                        component->OnTick(delta_time);
+                    }
 
-                for (const auto& entity : entities_copy)
+                    parallel_safe_count += parallel_safe ? 1 : 0;
+                }
+                components.Unlock();
+                components.SetParallelSafeCount(parallel_safe_count);
+            };
+
+            const auto is_ticked_first = [](const uint32_t type) { return type == ComponentType_Transform || type == ComponentType_Camera; };
+
+            tick_serial(m_components[ComponentType_Transform]);
+            tick_serial(m_components[ComponentType_Camera]);
+            TransformsUpdate();
+
+            for (const ComponentArray& components : m_components)
+            {
+                auto tick_parallel_safe = [&components, delta_time](const uint32_t start, const uint32_t end)
                 {
-                    if (entity->IsPendingDestruction())
+                    for (uint32_t i = start; i < end; i++)
                     {
-                        _EntityRemove(entity);
+                        IComponent* component = components.GetComponents()[i];
+                        if (components.GetEntities()[i]->IsActive() && component->IsTickParallelSafe())
+                        {
+                            component->OnTick(delta_time);
+                        }
                     }
+                };
+
+                // Only types with enough parallel safe components are dispatched, the rest would just be walked by every worker
+                if (components.GetParallelSafeCount() >= parallel_threshold)
+                {
+                    threading->AddTaskLoop(tick_parallel_safe, components.GetCount(), parallel_grain);
+                }
+                else
+                {
+                    tick_parallel_safe(0, components.GetCount());
+                }
+            }
+
+            for (uint32_t type = 0; type < ComponentType_Unknown; type++)
+            {
+                if (!is_ticked_first(type))
+                {
+                    tick_serial(m_components[type]);
                 }
             }
 
-            // Notify Renderer
-            FIRE_EVENT_DATA(Event_World_Resolve_Complete, m_entities);
+            // Bring every transform which changed during the tick up to date, in one pass
+            TransformsUpdate();
+		}
+
+        if (m_is_dirty)
+        {
+            // Remove the entities marked for destruction, removing one marks its descendants so the list can grow
+            for (size_t i = 0; i < m_entities_pending_destruction.size(); i++)
+            {
+                const shared_ptr<Entity> entity = m_entities_pending_destruction[i];
+                _EntityRemove(entity);
+            }
+            m_entities_pending_destruction.clear();
+
+            // Notify Renderer, the subscribers run right away so they can read the entities and the changes in place
+            m_resolve.entities = &m_entities;
+            FIRE_EVENT_DATA(Event_World_Resolve_Complete, static_cast<const WorldResolve*>(&m_resolve));
             m_is_dirty = false;
+
+            // Start tracking changes again
+            ResolveClear();
+            m_resolve.full = false;
         }
 	}
 
@@ -143,6 +316,25 @@ namespace Spartan
         // Notify any systems that the entities are about to be cleared
 		FIRE_EVENT(Event_World_Unload);
 
+        for (const auto& entity : m_entities)
+        {
+            entity->m_world = nullptr;
+        }
+
+        for (ComponentArray& components : m_components)
+        {
+            components.Clear();
+        }
+        m_transforms.clear();
+        m_transforms_level_start.clear();
+        m_transforms_dirty = true;
+        m_entities_index.Clear();
+        m_entities_pending_destruction.clear();
+
+        // Whatever comes next is acquired from scratch
+        ResolveClear();
+        m_resolve.full = true;
+
         m_entities.clear();
         m_entities.shrink_to_fit();
 
@@ -168,7 +360,7 @@ namespace Spartan
 		// Notify subsystems that need to save data
 		FIRE_EVENT(Event_World_Save);
 
-		// Create a prefab file
+		// Create a prefab file, uncompressed so that it can be mapped and single chunks can be read through the offset table
 		auto file = make_unique<FileStream>(file_path, FileStream_Write);
 		if (!file->IsOpen())
 		{
@@ -182,20 +374,35 @@ namespace Spartan
 
 		ProgressReport::Get().SetJobCount(g_progress_world, root_entity_count);
 
-		// Save root entity count
+		// Serialize each root entity's subtree into its own chunk
+		vector<vector<std::byte>> chunks(root_entity_count);
+		for (uint32_t i = 0; i < root_entity_count; i++)
+		{
+			FileStream chunk(&chunks[i]);
+			SerializeChunk(&chunk, root_actors[i].get());
+			ProgressReport::Get().IncrementJobsDone(g_progress_world);
+		}
+
+		// Save header
+		file->Write(world_magic);
+		file->Write(world_version);
 		file->Write(root_entity_count);
 
-		// Save root entity IDs
-		for (const auto& root : root_actors)
+		// Save offset table
+		uint64_t offset = world_header_size + root_entity_count * world_chunk_entry_size;
+		for (uint32_t i = 0; i < root_entity_count; i++)
 		{
-			file->Write(root->GetId());
+			file->Write(root_actors[i]->GetId());
+			file->Write(offset);
+			file->Write(static_cast<uint64_t>(chunks[i].size()));
+			file->Write(Utility::Hash::fnv1a_64(chunks[i].data(), chunks[i].size()));
+			offset += sizeof(uint32_t) + chunks[i].size();
 		}
 
-		// Save root entities
-		for (const auto& root : root_actors)
+		// Save chunks
+		for (const auto& chunk : chunks)
 		{
-			root->Serialize(file.get());
-			ProgressReport::Get().IncrementJobsDone(g_progress_world);
+			file->Write(chunk);
 		}
 
 		// Finish with progress report and timer
@@ -203,7 +410,7 @@ namespace Spartan
 		LOG_INFO("Saving took %.2f ms", timer.GetElapsedTimeMs());
 
 		// Notify subsystems waiting for us to finish
-		FIRE_EVENT(Event_World_Saved);
+		FIRE_EVENT_DEFERRED(Event_World_Saved);
 
 		return true;
 	}
@@ -216,8 +423,67 @@ namespace Spartan
 			return false;
 		}
 
-		// Thread safety: Wait for scene and the renderer to stop the entities (could do double buffering in the future)
-		while (m_state != Loading || m_context->GetSubsystem<Renderer>()->IsRendering()) { m_state = Request_Loading; this_thread::sleep_for(chrono::milliseconds(16)); }
+		// Thread safety: Wait for the world and the renderer to stop using the entities, without an engine (e.g. tools) nothing ticks or renders them
+		if (m_context->m_engine)
+		{
+			while (m_state != Loading || m_context->GetSubsystem<Renderer>()->IsRendering()) { m_state = Request_Loading; this_thread::sleep_for(chrono::milliseconds(16)); }
+		}
+
+		auto file = make_unique<FileStream>(file_path, FileStream_Read | FileStream_Mmap);
+		if (!file->IsOpen())
+			return false;
+
+		return LoadFromStream(file.get(), file_path);
+	}
+
+    void World::LoadFromFileAsync(const string& file_path)
+    {
+        if (!FileSystem::Exists(file_path))
+        {
+            LOG_ERROR("%s was not found.", file_path.c_str());
+            return;
+        }
+
+        // The world stops ticking once it picks up the request during its tick
+        if (m_state != Loading)
+        {
+            m_state = Request_Loading;
+        }
+
+        // The file is read on the I/O thread while the frames go on
+        m_context->GetSubsystem<Threading>()->ReadFileAsync(file_path, [this, file_path](vector<std::byte>&& data)
+        {
+            LoadFromMemoryDeferred(file_path, make_shared<vector<std::byte>>(move(data)));
+        }, Task_Background);
+    }
+
+    void World::LoadFromMemoryDeferred(const string& file_path, const shared_ptr<vector<std::byte>>& data)
+    {
+        m_context->GetSubsystem<Threading>()->AddTaskNextFrame([this, file_path, data]()
+        {
+            // Not there yet, check again at the end of the next frame
+            if (m_state != Loading || m_context->GetSubsystem<Renderer>()->IsRendering())
+            {
+                LoadFromMemoryDeferred(file_path, data);
+                return;
+            }
+
+            FileStream file(data->data(), data->size(), FileStream_Read | FileStream_Compressed);
+            if (data->empty() || !file.IsOpen())
+            {
+                LOG_ERROR("Failed to load \"%s\"", file_path.c_str());
+                m_state = Ticking;
+                return;
+            }
+
+            LoadFromStream(&file, file_path);
+        }, Task_Background);
+    }
+
+    bool World::LoadFromStream(FileStream* file, const string& file_path)
+    {
+        // Nothing can tick the entities while they are replaced
+        m_state = Loading;
 
 		// Start progress report and timing
 		ProgressReport::Get().Reset(g_progress_world);
@@ -228,18 +494,352 @@ namespace Spartan
 		// Unload current entities
 		Unload();
 
-		// Read all the resource file paths
-		auto file = make_unique<FileStream>(file_path, FileStream_Read);
-		if (!file->IsOpen())
-			return false;
-
 		m_name = FileSystem::GetFileNameNoExtensionFromFilePath(file_path);
 
 		// Notify subsystems that need to load data
 		FIRE_EVENT(Event_World_Load);
 
+		// Load header and offset table
+		vector<WorldChunk> chunks;
+		if (file->ReadAs<uint32_t>() != world_magic)
+		{
+			file->Seek(0);
+			LoadFromFileLegacy(file);
+		}
+		else if (ReadChunkTable(file, &chunks))
+		{
+			ProgressReport::Get().SetJobCount(g_progress_world, static_cast<uint32_t>(chunks.size()));
+			LoadChunks(file, chunks);
+		}
+
+		m_is_dirty	= true;
+		m_state		= Ticking;
+		ProgressReport::Get().SetIsLoading(g_progress_world, false);	
+		LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
+
+		FIRE_EVENT_DEFERRED(Event_World_Loaded);
+		return true;
+    }
+
+    bool World::LoadEntityFromFile(const string& file_path, const uint32_t root_id)
+    {
+        auto file = make_unique<FileStream>(file_path, FileStream_Read | FileStream_Mmap);
+        if (!file->IsOpen())
+            return false;
+
+        vector<WorldChunk> chunks;
+        if (file->ReadAs<uint32_t>() != world_magic || !ReadChunkTable(file.get(), &chunks))
+        {
+            LOG_ERROR("\"%s\" has no offset table, it has to be loaded as a whole", file_path.c_str());
+            return false;
+        }
+
+        // Jump straight to the chunk, the others aren't touched
+        for (WorldChunk& chunk : chunks)
+        {
+            if (chunk.root_id == root_id)
+            {
+                vector<WorldChunk> chunk_single(1);
+                chunk_single[0] = move(chunk);
+                return LoadChunks(file.get(), chunk_single) != 0;
+            }
+        }
+
+        LOG_ERROR("\"%s\" has no root entity with an id of %d", file_path.c_str(), root_id);
+        return false;
+    }
+
+    void World::SerializeChunk(FileStream* stream, Entity* root) const
+    {
+        // Flatten the subtree, parents come before their children
+        vector<Entity*> entities = { root };
+        for (size_t i = 0; i < entities.size(); i++)
+        {
+            for (Transform* child : entities[i]->GetTransform()->GetChildren())
+            {
+                if (child->GetEntity())
+                {
+                    entities.emplace_back(child->GetEntity());
+                }
+            }
+        }
+
+        // Entities and the components they have
+        array<vector<IComponent*>, ComponentType_Unknown> groups;
+        stream->Write(static_cast<uint32_t>(entities.size()));
+        for (Entity* entity : entities)
+        {
+            stream->Write(entity->IsActive());
+            stream->Write(entity->IsVisibleInHierarchy());
+            stream->Write(entity->GetId());
+            stream->Write(entity->GetName());
+
+            const auto& components = entity->GetAllComponents();
+            stream->Write(static_cast<uint32_t>(components.size()));
+            for (const auto& component : components)
+            {
+                stream->Write(static_cast<uint32_t>(component->GetType()));
+                stream->Write(component->GetId());
+
+                if (component->GetType() < ComponentType_Unknown)
+                {
+                    groups[component->GetType()].emplace_back(component.get());
+                }
+            }
+        }
+
+        // Component data grouped by type, transforms go first as other components build on them when deserializing
+        vector<uint32_t> types = { ComponentType_Transform };
+        for (uint32_t type = 0; type < ComponentType_Unknown; type++)
+        {
+            if (type != ComponentType_Transform && !groups[type].empty())
+            {
+                types.emplace_back(type);
+            }
+        }
+
+        stream->Write(static_cast<uint32_t>(types.size()));
+        for (const uint32_t type : types)
+        {
+            vector<std::byte> data;
+            FileStream group(&data);
+            for (IComponent* component : groups[type])
+            {
+                component->Serialize(&group);
+            }
+
+            stream->Write(type);
+            stream->Write(static_cast<uint32_t>(groups[type].size()));
+            stream->Write(data);
+        }
+    }
+
+    uint32_t World::LoadChunks(FileStream* stream, vector<WorldChunk>& chunks)
+    {
+        // Locate the chunks up front, this moves the stream
+        for (WorldChunk& chunk : chunks)
+        {
+            stream->Seek(chunk.offset);
+
+            uint32_t size = 0;
+            chunk.data = stream->ReadView<std::byte>(&size);
+            if (size != chunk.size)
+            {
+                chunk.data = nullptr;
+            }
+        }
+
+        // Verify and parse the chunks in parallel, a corrupt one only loses its own entities. Chunks written before
+        // component groups were sized can't defer anything, so they are parsed on this thread.
+        m_context->GetSubsystem<Threading>()->AddTaskLoop([this, &chunks](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                if (chunks[i].version < 3)
+                    continue;
+
+                chunks[i].loaded = DeserializeChunk(chunks[i]);
+                ProgressReport::Get().IncrementJobsDone(g_progress_world);
+            }
+        }, static_cast<uint32_t>(chunks.size()), 1);
+
+        // All the parsed entities, the deferred components can reference any of them
+        vector<shared_ptr<Entity>> entities;
+        for (WorldChunk& chunk : chunks)
+        {
+            if (chunk.version < 3)
+            {
+                chunk.loaded = DeserializeChunk(chunk);
+                ProgressReport::Get().IncrementJobsDone(g_progress_world);
+            }
+
+            if (chunk.loaded)
+            {
+                entities.insert(entities.end(), chunk.entities.begin(), chunk.entities.end());
+            }
+        }
+
+        // Finish the deferred components, on this thread
+        EntityIndex entities_index;
+        for (const auto& entity : entities)
+        {
+            entities_index.Add(entity);
+        }
+        entities_loading = &entities_index;
+        for (WorldChunk& chunk : chunks)
+        {
+            if (!chunk.loaded)
+                continue;
+
+            for (const WorldChunkComponent& component : chunk.components_deferred)
+            {
+                const IComponent* added = component.entity->AddComponent(static_cast<ComponentType>(component.type), component.id);
+
+                // Put it back where it was saved, the components which were created in parallel are in front of it. The deferred
+                // components come in their saved order, so everything before the position is already there.
+                auto& components = component.entity->m_components;
+                if (added && components.back().get() == added && component.index < components.size() - 1)
+                {
+                    rotate(components.begin() + component.index, components.end() - 1, components.end());
+                }
+            }
+
+            for (const WorldChunkGroup& group : chunk.groups_deferred)
+            {
+                FileStream group_stream(group.data, group.size);
+                if (!deserialize_components(&group_stream, chunk.entities, group.type, group.count))
+                {
+                    chunk.loaded = false;
+                    break;
+                }
+            }
+        }
+        entities_loading = nullptr;
+
+        // Publish the entities in one step and link the hierarchy, the transforms only know their parents so far and
+        // parents come before their children, so the children end up in the order they were saved in
+        uint32_t loaded_count = 0;
+        for (WorldChunk& chunk : chunks)
+        {
+            if (!chunk.loaded || chunk.entities.empty())
+                continue;
+
+            m_entities.insert(m_entities.end(), chunk.entities.begin(), chunk.entities.end());
+            for (const auto& entity : chunk.entities)
+            {
+                Transform* transform = entity->GetTransform();
+                if (transform && transform->m_parent)
+                {
+                    transform->m_parent->m_children.emplace_back(transform);
+                }
+
+                EntityRegister(entity);
+            }
+            loaded_count++;
+        }
+
+        // Events and world changes were held back while the chunks were deserialized, everything resolves at once
+        FIRE_EVENT(Event_World_Resolve_Pending);
+
+        return loaded_count;
+    }
+
+    bool World::DeserializeChunk(WorldChunk& chunk)
+    {
+        if (!chunk.data || Utility::Hash::fnv1a_64(chunk.data, chunk.size) != chunk.checksum)
+        {
+            LOG_ERROR("The chunk of root entity %d is corrupt, skipping it", chunk.root_id);
+            return false;
+        }
+
+        // Without sized groups, everything has to be deserialized in order
+        const bool defer = chunk.version >= 3;
+
+        FileStream stream(chunk.data, chunk.size);
+
+        // Create the entities and the components which can be created here
+        const auto entity_count = stream.ReadAs<uint32_t>();
+        chunk.entities.reserve(entity_count);
+        for (uint32_t i = 0; i < entity_count; i++)
+        {
+            const shared_ptr<Entity>& entity = chunk.entities.emplace_back(make_shared<Entity>(m_context));
+            entity->SetActive(stream.ReadAs<bool>());
+            entity->SetHierarchyVisibility(stream.ReadAs<bool>());
+            entity->SetId(stream.ReadAs<uint32_t>());
+            entity->SetName(stream.ReadAs<string>());
+
+            const auto component_count = stream.ReadAs<uint32_t>();
+            for (uint32_t j = 0; j < component_count; j++)
+            {
+                WorldChunkComponent component;
+                component.entity    = entity.get();
+                component.type      = stream.ReadAs<uint32_t>();
+                component.id        = stream.ReadAs<uint32_t>();
+                component.index     = j;
+
+                if (defer && !is_parallel_safe(component.type))
+                {
+                    chunk.components_deferred.emplace_back(component);
+                }
+                else
+                {
+                    entity->AddComponent(static_cast<ComponentType>(component.type), component.id);
+                }
+            }
+        }
+
+        // Deserialize the components, all of them exist by now so they can reference each other
+        EntityIndex entities_index;
+        for (const auto& entity : chunk.entities)
+        {
+            entities_index.Add(entity);
+        }
+        const EntityIndex* entities_loading_previous = entities_loading;
+        entities_loading = &entities_index;
+
+        bool result = true;
+        const auto group_count = stream.ReadAs<uint32_t>();
+        for (uint32_t i = 0; i < group_count && result; i++)
+        {
+            WorldChunkGroup group;
+            group.type  = stream.ReadAs<uint32_t>();
+            group.count = stream.ReadAs<uint32_t>();
+
+            if (!defer)
+            {
+                result = deserialize_components(&stream, chunk.entities, group.type, group.count);
+                continue;
+            }
+
+            uint32_t size   = 0;
+            group.data      = stream.ReadView<std::byte>(&size);
+            group.size      = size;
+            if (!group.data)
+            {
+                result = false;
+            }
+            else if (!is_parallel_safe(group.type))
+            {
+                chunk.groups_deferred.emplace_back(group);
+            }
+            else
+            {
+                FileStream group_stream(group.data, group.size);
+                result = deserialize_components(&group_stream, chunk.entities, group.type, group.count);
+            }
+        }
+
+        entities_loading = entities_loading_previous;
+
+        return result;
+    }
+
+    bool World::ReadChunkTable(FileStream* stream, vector<WorldChunk>* chunks)
+    {
+        const auto version = stream->ReadAs<uint32_t>();
+        if (version > world_version)
+        {
+            LOG_ERROR("World version %d is newer than the supported %d", version, world_version);
+            return false;
+        }
+
+        chunks->resize(stream->ReadAs<uint32_t>());
+        for (WorldChunk& chunk : *chunks)
+        {
+            chunk.version = version;
+            stream->Read(&chunk.root_id);
+            stream->Read(&chunk.offset);
+            stream->Read(&chunk.size);
+            stream->Read(&chunk.checksum);
+        }
+
+        return true;
+    }
+
+    void World::LoadFromFileLegacy(FileStream* stream)
+    {
 		// Load root entity count
-        const auto root_entity_count = file->ReadAs<uint32_t>();
+        const auto root_entity_count = stream->ReadAs<uint32_t>();
 
 		ProgressReport::Get().SetJobCount(g_progress_world, root_entity_count);
 
@@ -247,29 +847,22 @@ namespace Spartan
 		for (uint32_t i = 0; i < root_entity_count; i++)
 		{
 			auto& entity = EntityCreate();
-			entity->SetId(file->ReadAs<uint32_t>());
+			entity->SetId(stream->ReadAs<uint32_t>());
 		}
 
 		// Serialize root entities
 		for (uint32_t i = 0; i < root_entity_count; i++)
 		{
-			m_entities[i]->Deserialize(file.get(), nullptr);
+			m_entities[i]->Deserialize(stream, nullptr);
 			ProgressReport::Get().IncrementJobsDone(g_progress_world);
 		}
-
-		m_is_dirty	= true;
-		m_state		= Ticking;
-		ProgressReport::Get().SetIsLoading(g_progress_world, false);	
-		LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
-
-		FIRE_EVENT(Event_World_Loaded);
-		return true;
-	}
+    }
 
     shared_ptr<Entity>& World::EntityCreate(bool is_active /*= true*/)
     {
         auto& entity = m_entities.emplace_back(make_shared<Entity>(m_context));
         entity->SetActive(is_active);
+        EntityRegister(entity);
         return entity;
     }
 
@@ -280,6 +873,7 @@ namespace Spartan
 		if (!entity)
 			return empty;
 
+        EntityRegister(entity);
 		return m_entities.emplace_back(entity);
 	}
 
@@ -298,7 +892,11 @@ namespace Spartan
 
         // Mark for destruction but don't delete now
 	    // as the Renderer might still be using it.
-        entity->MarkForDestruction();
+        if (!entity->IsPendingDestruction())
+        {
+            entity->MarkForDestruction();
+            m_entities_pending_destruction.emplace_back(entity);
+        }
         m_is_dirty = true;
 	}
 
@@ -318,26 +916,33 @@ namespace Spartan
 
 	const shared_ptr<Entity>& World::EntityGetByName(const string& name)
 	{
-		for (const auto& entity : m_entities)
-		{
-			if (entity->GetName() == name)
-				return entity;
-		}
+        const shared_ptr<Entity>& entity = m_entities_index.GetByName(name);
+        if (entity || !entities_loading)
+            return entity;
 
-        static shared_ptr<Entity> empty;
-		return empty;
+        return entities_loading->GetByName(name);
 	}
 
+    vector<shared_ptr<Entity>> World::EntityGetAllByName(const string& name)
+    {
+        vector<shared_ptr<Entity>> entities = m_entities_index.GetAllByName(name);
+
+        if (entities_loading)
+        {
+            const vector<shared_ptr<Entity>> entities_loaded = entities_loading->GetAllByName(name);
+            entities.insert(entities.end(), entities_loaded.begin(), entities_loaded.end());
+        }
+
+        return entities;
+    }
+
 	const shared_ptr<Entity>& World::EntityGetById(const uint32_t id)
 	{
-		for (const auto& entity : m_entities)
-		{
-			if (entity->GetId() == id)
-				return entity;
-		}
+        const shared_ptr<Entity>& entity = m_entities_index.GetById(id);
+        if (entity || !entities_loading)
+            return entity;
 
-        static shared_ptr<Entity> empty;
-		return empty;
+        return entities_loading->GetById(id);
 	}
 
     // Removes an entity and all of it's children
@@ -359,6 +964,7 @@ namespace Spartan
             const auto temp = *it;
             if (temp->GetId() == entity->GetId())
             {
+                EntityUnregister(temp.get());
                 it = m_entities.erase(it);
                 break;
             }
@@ -408,4 +1014,209 @@ namespace Spartan
 
 		return light;
 	}
+
+    void World::ComponentRegister(IComponent* component)
+    {
+        if (component->GetType() < ComponentType_Unknown)
+        {
+            m_components[component->GetType()].Add(component);
+        }
+
+        EntityChanged(component->GetEntity());
+
+        if (component->GetType() == ComponentType_Transform)
+        {
+            m_transforms_dirty = true;
+        }
+    }
+
+    void World::ComponentUnregister(IComponent* component)
+    {
+        if (component->GetType() < ComponentType_Unknown)
+        {
+            m_components[component->GetType()].Remove(component);
+        }
+
+        EntityChanged(component->GetEntity());
+
+        if (component->GetType() == ComponentType_Transform)
+        {
+            m_transforms_dirty = true;
+        }
+    }
+
+    void World::EntityRegister(const shared_ptr<Entity>& entity)
+    {
+        if (entity->m_world == this)
+            return;
+
+        entity->m_world = this;
+        m_entities_index.Add(entity);
+        m_is_dirty      = true;
+
+        // A full resolve picks it up anyway
+        if (!m_resolve.full)
+        {
+            entity->m_resolve_added = true;
+            m_resolve.added.emplace_back(entity);
+        }
+
+        for (const auto& component : entity->GetAllComponents())
+        {
+            ComponentRegister(component.get());
+        }
+    }
+
+    void World::EntityUnregister(Entity* entity)
+    {
+        if (entity->m_world != this)
+            return;
+
+        entity->m_world = nullptr;
+        for (const auto& component : entity->GetAllComponents())
+        {
+            ComponentUnregister(component.get());
+        }
+        m_entities_index.Remove(entity);
+
+        // Added or changed and then removed before a resolve, only the removal matters
+        auto erase = [entity](vector<shared_ptr<Entity>>& entities)
+        {
+            for (auto it = entities.begin(); it != entities.end(); ++it)
+            {
+                if (it->get() == entity)
+                {
+                    entities.erase(it);
+                    return;
+                }
+            }
+        };
+
+        if (entity->m_resolve_added)
+        {
+            erase(m_resolve.added);
+            entity->m_resolve_added = false;
+        }
+        else if (!m_resolve.full)
+        {
+            m_resolve.removed.emplace_back(entity->GetPtrShared());
+        }
+
+        if (entity->m_resolve_changed)
+        {
+            erase(m_resolve.changed);
+            entity->m_resolve_changed = false;
+        }
+    }
+
+    void World::EntityChanged(Entity* entity)
+    {
+        m_is_dirty = true;
+
+        // Entities which were just added are acquired as a whole anyway
+        if (m_resolve.full || entity->m_world != this || entity->m_resolve_added || entity->m_resolve_changed)
+            return;
+
+        entity->m_resolve_changed = true;
+        m_resolve.changed.emplace_back(entity->GetPtrShared());
+    }
+
+    void World::EntityRenamed(Entity* entity, const string& name_old)
+    {
+        m_entities_index.OnRenamed(entity, name_old);
+    }
+
+    void World::EntityIdChanged(Entity* entity, const uint32_t id_old)
+    {
+        m_entities_index.OnIdChanged(entity, id_old);
+    }
+
+    void World::TransformsUpdate()
+    {
+        // Nothing moved and the layout is the same, so there is nothing to walk. The flag is cleared before walking,
+        // a transform which is marked dirty during the walk is picked up by the next update.
+        const bool layout_changed = m_transforms_dirty.exchange(false);
+        if (!m_transforms_changed.exchange(false, memory_order_relaxed) && !layout_changed)
+            return;
+
+        // Rebuild the update order, roots first and then each level's children
+        if (layout_changed)
+        {
+            m_transforms.clear();
+            m_transforms_level_start.clear();
+
+            const ComponentView<Transform> transforms = ComponentGetAll<Transform>();
+            for (Transform* transform : transforms)
+            {
+                if (!transform->HasParent())
+                {
+                    m_transforms.emplace_back(transform);
+                }
+            }
+
+            uint32_t level_start = 0;
+            while (level_start < static_cast<uint32_t>(m_transforms.size()))
+            {
+                const uint32_t level_end = static_cast<uint32_t>(m_transforms.size());
+                m_transforms_level_start.emplace_back(level_start);
+
+                for (uint32_t i = level_start; i < level_end; i++)
+                {
+                    const vector<Transform*>& children = m_transforms[i]->GetChildren();
+                    m_transforms.insert(m_transforms.end(), children.begin(), children.end());
+                }
+
+                level_start = level_end;
+            }
+            m_transforms_level_start.emplace_back(level_start);
+        }
+
+        // The parents of a level are resolved by the time it starts, so the transforms within a level don't depend on each other
+        static const uint32_t parallel_threshold    = 1024;
+        static const uint32_t parallel_grain        = 256;
+        Threading* threading = m_context->GetSubsystem<Threading>();
+
+        for (uint32_t level = 0; level + 1 < static_cast<uint32_t>(m_transforms_level_start.size()); level++)
+        {
+            Transform** transforms  = m_transforms.data() + m_transforms_level_start[level];
+            const uint32_t count    = m_transforms_level_start[level + 1] - m_transforms_level_start[level];
+
+            auto resolve = [transforms](const uint32_t start, const uint32_t end)
+            {
+                for (uint32_t i = start; i < end; i++)
+                {
+                    if (transforms[i]->IsDirty())
+                    {
+                        transforms[i]->Resolve();
+                    }
+                }
+            };
+
+            if (count >= parallel_threshold)
+            {
+                threading->AddTaskLoop(resolve, count, parallel_grain);
+            }
+            else
+            {
+                resolve(0, count);
+            }
+        }
+    }
+
+    void World::ResolveClear()
+    {
+        for (const auto& entity : m_resolve.added)
+        {
+            entity->m_resolve_added = false;
+        }
+
+        for (const auto& entity : m_resolve.changed)
+        {
+            entity->m_resolve_changed = false;
+        }
+
+        m_resolve.added.clear();
+        m_resolve.removed.clear();
+        m_resolve.changed.clear();
+    }
 }
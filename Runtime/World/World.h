@@ -25,16 +25,34 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include <memory>
 #include <string>
+#include <atomic>
+#include <cstddef>
 #include "../Core/EngineDefs.h"
 #include "../Core/ISubsystem.h"
+#include "../Core/EventSystem.h"
+#include "ComponentStorage.h"
+#include "EntityIndex.h"
 //=============================
 
 namespace Spartan
 {
 	class Entity;
+	class Transform;
 	class Light;
 	class Input;
 	class Profiler;
+	class FileStream;
+	struct WorldChunk;
+
+	// What changed in the world since it last resolved, so systems can update incrementally
+	struct WorldResolve
+	{
+		bool full = true; // everything changed (a world was loaded), re-acquire from scratch
+		const std::vector<std::shared_ptr<Entity>>* entities = nullptr;
+		std::vector<std::shared_ptr<Entity>> added;
+		std::vector<std::shared_ptr<Entity>> removed; // kept alive until the resolve completes
+		std::vector<std::shared_ptr<Entity>> changed; // components were added or removed, or the active state changed
+	};
 
 	enum Scene_State
 	{
@@ -57,9 +75,15 @@ namespace Spartan
 		
 		void Unload();
 		bool SaveToFile(const std::string& filePath);
+        // Loads on the calling thread once the world has stopped ticking and the renderer is done, so it can't be the thread which ticks them
 		bool LoadFromFile(const std::string& file_path);
+        // Reads the file on the I/O thread, then loads it on a worker at the first frame boundary where the world and the renderer have stopped
+        void LoadFromFileAsync(const std::string& file_path);
+        // Loads a single root entity (and its descendants) from a world file, call it where creating entities is safe
+        bool LoadEntityFromFile(const std::string& file_path, uint32_t root_id);
 		const auto& GetName() const { return m_name; }
-        void MakeDirty() { m_is_dirty = true; }
+        // Makes the next resolve a full one, for changes which can't be tracked per entity
+        void MakeDirty() { m_is_dirty = true; m_resolve.full = true; }
 
 		//= Entities ===========================================================================
 		std::shared_ptr<Entity>& EntityCreate(bool is_active = true);
@@ -68,13 +92,48 @@ namespace Spartan
 		void EntityRemove(const std::shared_ptr<Entity>& entity);	
 		std::vector<std::shared_ptr<Entity>> EntityGetRoots();
 		const std::shared_ptr<Entity>& EntityGetByName(const std::string& name);
+		std::vector<std::shared_ptr<Entity>> EntityGetAllByName(const std::string& name);  // every entity with that name
 		const std::shared_ptr<Entity>& EntityGetById(uint32_t id);
 		const auto& EntityGetAll() const    { return m_entities; }
 		auto EntityGetCount() const         { return static_cast<uint32_t>(m_entities.size()); }
 		//======================================================================================
 
+		//= Components ====================================================================================================
+		// Every component of type T in the world, packed together for bulk iteration
+		template <class T>
+		ComponentView<T> ComponentGetAll() const { return ComponentView<T>(m_components[IComponent::TypeToEnum<T>()]); }
+		void ComponentRegister(IComponent* component);
+		void ComponentUnregister(IComponent* component);
+		// Components are allocated from these, whatever is still alive when the world goes away keeps them around
+		const std::shared_ptr<ComponentPools>& GetComponentPools() const { return m_component_pools; }
+		// The parent-child layout changed, the transform update order has to be rebuilt
+		void TransformsMakeDirty() { m_transforms_dirty = true; }
+		// A transform became dirty, the next update has something to resolve
+		void TransformsMarkChanged() { m_transforms_changed.store(true, std::memory_order_relaxed); }
+		// Brings every dirty transform up to date, parents before children. The world does it while ticking.
+		void TransformsUpdate();
+		//=================================================================================================================
+
 	private:
+        friend class Entity;
+
         void _EntityRemove(const std::shared_ptr<Entity>& entity);
+        void EntityRegister(const std::shared_ptr<Entity>& entity);
+        void EntityUnregister(Entity* entity);
+        void EntityRenamed(Entity* entity, const std::string& name_old);
+        void EntityIdChanged(Entity* entity, uint32_t id_old);
+        void EntityChanged(Entity* entity);
+        void ResolveClear();
+
+		//= SERIALIZATION =====================================================
+		void LoadFromMemoryDeferred(const std::string& file_path, const std::shared_ptr<std::vector<std::byte>>& data);
+		bool LoadFromStream(FileStream* file, const std::string& file_path);
+		void SerializeChunk(FileStream* stream, Entity* root) const;
+		bool ReadChunkTable(FileStream* stream, std::vector<WorldChunk>* chunks);
+		uint32_t LoadChunks(FileStream* stream, std::vector<WorldChunk>& chunks);
+		bool DeserializeChunk(WorldChunk& chunk);
+		void LoadFromFileLegacy(FileStream* stream);
+		//=====================================================================
 
 		//= COMMON ENTITY CREATION ========================
 		std::shared_ptr<Entity>& CreateEnvironment();
@@ -90,5 +149,21 @@ namespace Spartan
         Profiler* m_profiler        = nullptr;
 
         std::vector<std::shared_ptr<Entity>> m_entities;
+        std::vector<std::shared_ptr<Entity>> m_entities_pending_destruction;
+        EntityIndex m_entities_index;
+        WorldResolve m_resolve;
+        ComponentArray m_components[ComponentType_Unknown];
+        std::shared_ptr<ComponentPools> m_component_pools = std::make_shared<ComponentPools>();
+
+        // Transforms ordered parents before children, one hierarchy level after the other
+        std::vector<Transform*> m_transforms;
+        std::vector<uint32_t> m_transforms_level_start;
+        std::atomic<bool> m_transforms_dirty    = true;
+        std::atomic<bool> m_transforms_changed  = true; // a transform was marked dirty since the last update
+
+        // Events
+        EventHandle m_event_world_resolve_pending;
+        EventHandle m_event_world_stop;
+        EventHandle m_event_world_start;
 	};
 }
@@ -21,10 +21,12 @@
 SOLUTION_NAME		= "Spartan"
 EDITOR_NAME			= "Editor"
 RUNTIME_NAME		= "Runtime"
+BENCHMARK_NAME		= "Benchmark"
 TARGET_NAME			= "Spartan" -- Name of executable
 DEBUG_FORMAT		= "c7"
 EDITOR_DIR			= "../" .. EDITOR_NAME
 RUNTIME_DIR			= "../" .. RUNTIME_NAME
+BENCHMARK_DIR		= "../" .. BENCHMARK_NAME
 LIBRARY_DIR			= "../ThirdParty/libraries"
 INTERMEDIATE_DIR	= "../Binaries/Intermediate"
 TARGET_DIR_RELEASE  = "../Binaries/Release"
@@ -173,4 +175,38 @@ project (EDITOR_NAME)
 	-- "Release"
 	filter "configurations:Release"
 		targetdir (TARGET_DIR_RELEASE)
-		debugdir (TARGET_DIR_RELEASE)
\ No newline at end of file
+		debugdir (TARGET_DIR_RELEASE)
+
+-- Benchmark -----------------------------------------------------------------------------------------------
+project (BENCHMARK_NAME)
+	location (BENCHMARK_DIR)
+	links { RUNTIME_NAME }
+	dependson { RUNTIME_NAME }
+	objdir (INTERMEDIATE_DIR)
+	kind "ConsoleApp"
+	staticruntime "On"
+	defines{ API_GRAPHICS }
+	
+	-- Files
+	files 
+	{ 
+		BENCHMARK_DIR .. "/**.h",
+		BENCHMARK_DIR .. "/**.cpp"
+	}
+	
+	-- Includes
+	includedirs { "../" .. RUNTIME_NAME }
+	
+	-- Libraries
+	libdirs (LIBRARY_DIR)
+
+	-- "Debug"
+	filter "configurations:Debug"
+		targetdir (TARGET_DIR_DEBUG)	
+		debugdir (TARGET_DIR_DEBUG)
+		debugformat (DEBUG_FORMAT)		
+				
+	-- "Release"
+	filter "configurations:Release"
+		targetdir (TARGET_DIR_RELEASE)
+		debugdir (TARGET_DIR_RELEASE)